@@ -0,0 +1,17 @@
+#include "coroutineSolver.h"
+
+#ifdef SOLVER_COROUTINES
+//the scheduler, one tick runs the coroutine up to its next move
+void coroutineSolver::studentAI()
+{
+    if(this->isNewMaze() || !_task.isRunning())
+    {
+        _task = this->run();
+    }
+    _task.resume();
+    if(!_task.isRunning())
+    {
+        mazeSolver::foundFinish();
+    }
+}
+#endif
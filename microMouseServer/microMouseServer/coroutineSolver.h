@@ -0,0 +1,111 @@
+#ifndef COROUTINESOLVER_H
+#define COROUTINESOLVER_H
+
+#include "mazeSolver.h"
+
+//C++20 only, the rest of the sim builds without it
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define SOLVER_COROUTINES 1
+#endif
+#endif
+
+#ifdef SOLVER_COROUTINES
+#include <coroutine>
+#include <exception>
+
+//what coroutineSolver::run() returns, owns the coroutine frame
+class solverTask
+{
+public:
+    struct promise_type
+    {
+        solverTask get_return_object() { return solverTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        //nothing runs until the first tick
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    solverTask() : _handle(nullptr) {}
+    solverTask(solverTask &&other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+    solverTask &operator=(solverTask &&other) noexcept
+    {
+        if(this != &other)
+        {
+            if(_handle) _handle.destroy();
+            _handle = other._handle;
+            other._handle = nullptr;
+        }
+        return *this;
+    }
+    ~solverTask() { if(_handle) _handle.destroy(); }
+    solverTask(const solverTask &) = delete;
+    solverTask &operator=(const solverTask &) = delete;
+
+    bool isRunning() const { return _handle && !_handle.done(); }
+    void resume() { _handle.resume(); }
+
+private:
+    explicit solverTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+//An action that has already happened, co_await gives its result. Moves and
+//foundFinish() end the tick, the coroutine carries on from there next tick
+template<typename T>
+struct solverAction
+{
+    T result;
+    bool endsTick;
+
+    bool await_ready() const noexcept { return !endsTick; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    T await_resume() const noexcept { return result; }
+};
+
+template<>
+struct solverAction<void>
+{
+    bool endsTick;
+
+    bool await_ready() const noexcept { return !endsTick; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    void await_resume() const noexcept {}
+};
+
+//Base class of solvers written as one straight loop instead of a function that is
+//called again every tick. run() co_awaits the student api and the scheduler in
+//studentAI() resumes it once a tick, up to its next move or foundFinish(). So a
+//tick is exactly one move, however the GUI or the batch tools pace the ticks.
+//
+//A new maze throws the coroutine away and starts run() again, anything worth
+//keeping across runs goes in members. run() should loop over the runs for ever:
+//when it returns the run ends, and the next tick starts it from the top.
+class coroutineSolver : public mazeSolver
+{
+protected:
+    virtual solverTask run() = 0;
+
+    solverAction<bool> isWallLeft() { return {mazeSolver::isWallLeft(), false}; }
+    solverAction<bool> isWallRight() { return {mazeSolver::isWallRight(), false}; }
+    solverAction<bool> isWallForward() { return {mazeSolver::isWallForward(), false}; }
+    solverAction<int> senseWalls() { return {mazeSolver::senseWalls(), false}; }
+    solverAction<int> senseWallsRelative() { return {mazeSolver::senseWallsRelative(), false}; }
+    solverAction<void> turnLeft() { mazeSolver::turnLeft(); return {false}; }
+    solverAction<void> turnRight() { mazeSolver::turnRight(); return {false}; }
+    solverAction<void> turnTo(mDirection dir) { mazeSolver::turnTo(dir); return {false}; }
+    solverAction<bool> moveForward() { return {mazeSolver::moveForward(), true}; }
+    solverAction<bool> moveDirection(mDirection dir) { return {mazeSolver::moveDirection(dir), true}; }
+    solverAction<void> foundFinish() { mazeSolver::foundFinish(); return {true}; }
+
+    void studentAI();
+
+private:
+    solverTask _task;
+};
+#endif
+
+#endif // COROUTINESOLVER_H
@@ -0,0 +1,77 @@
+//A solver plugin, built on its own by solverPlugin.pro. It only needs
+//solverPluginApi.h, copy both files to start a new one
+
+#include "solverPluginApi.h"
+
+//mDirection order: right, down, left, up
+static const int stepX[4] = {1, 0, -1, 0};
+static const int stepY[4] = {0, -1, 0, 1};
+
+//keeps its left hand on the wall, one move per tick. Fine for mazes without
+//islands around the goal, which is what it is there to be compared against
+class wallFollower : public pluginSolver
+{
+public:
+    wallFollower() : _x(0), _y(0), _heading(3), _moves(0) {}
+
+protected:
+    void studentAI()
+    {
+        if(this->isNewMaze())
+        {
+            this->restart();
+        }
+        if(_x == this->goalX() && _y == this->goalY())
+        {
+            this->finish();
+            return;
+        }
+        //every cell from every side and still no goal
+        if(_moves > 4L * this->mazeWidth() * this->mazeHeight())
+        {
+            this->printUI("Destination not reachable.");
+            this->finish();
+            return;
+        }
+
+        //left, ahead, right, back, the first way that is open
+        int walls = this->senseWalls();
+        for(int turn = 3; turn < 7; turn++)
+        {
+            int dir = (_heading + turn) % 4;
+            if(!(walls & (1 << dir)))
+            {
+                _heading = dir;
+                break;
+            }
+        }
+        if(this->moveDirection(_heading))
+        {
+            _x += stepX[_heading];
+            _y += stepY[_heading];
+        }
+        _moves++;
+    }
+
+private:
+    void restart()
+    {
+        _x = this->startX();
+        _y = this->startY();
+        _heading = 3;
+        _moves = 0;
+    }
+
+    //the next tick starts a run from the start cell
+    void finish()
+    {
+        this->restart();
+        this->foundFinish();
+    }
+
+    int _x, _y;
+    int _heading;
+    long _moves;
+};
+
+SOLVER_PLUGIN("wallFollower", wallFollower)
@@ -0,0 +1,250 @@
+#include "floodPlanner.h"
+#include <algorithm>
+
+//mDirection order, right turn is +1
+static const int floodDX[4] = {1, 0, -1, 0};
+static const int floodDY[4] = {0, -1, 0, 1};
+static const Wall floodWall[4] = {RIGHT, BOTTOM, LEFT, TOP};
+
+const uint32_t floodPlanner::UNREACHABLE;
+
+floodPlanner::floodPlanner(int width, int height)
+{
+    this->reset(width, height);
+}
+
+void floodPlanner::reset(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _walls.resize(width, height);
+    _dist.assign((size_t)width*height, UNREACHABLE);
+    _explored.assign((size_t)width*height/64 + 1, 0);
+    _goalX = _goalY = -1;
+    _goalW = _goalH = 0;
+}
+
+void floodPlanner::setGoal(int x, int y, int w, int h)
+{
+    _goalX = x;
+    _goalY = y;
+    _goalW = w;
+    _goalH = h;
+    this->flood();
+}
+
+bool floodPlanner::isGoal(int x, int y) const
+{
+    return x >= _goalX && x < _goalX + _goalW && y >= _goalY && y < _goalY + _goalH;
+}
+
+bool floodPlanner::isOpen(int x, int y, mDirection dir) const
+{
+    switch(dir)
+    {
+    case dRIGHT:
+        return !_walls.isWallRight(x, y);
+    case dDOWN:
+        return !_walls.isWallBottom(x, y);
+    case dLEFT:
+        return !_walls.isWallLeft(x, y);
+    case dUP:
+        return !_walls.isWallTop(x, y);
+    }
+    return false;
+}
+
+//-1 past the edge or through a known wall
+int floodPlanner::neighbour(int cell, mDirection dir) const
+{
+    int x = cell % _width, y = cell / _width;
+    if(!this->isOpen(x, y, dir))
+    {
+        return -1;
+    }
+    return (int)this->index(x + floodDX[dir], y + floodDY[dir]);
+}
+
+//a cell is still right if some open neighbour is one step closer
+bool floodPlanner::hasSupport(int cell) const
+{
+    uint32_t want = _dist[cell] - 1;
+    for(int dir = 0; dir < 4; dir++)
+    {
+        int next = this->neighbour(cell, mDirection(dir));
+        if(next >= 0 && _dist[next] == want)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//whole field from scratch, only needed when the goal moves
+void floodPlanner::flood()
+{
+    std::fill(_dist.begin(), _dist.end(), UNREACHABLE);
+    _queue.clear();
+    for(int y = std::max(_goalY, 0); y < std::min(_goalY + _goalH, _height); y++)
+    {
+        for(int x = std::max(_goalX, 0); x < std::min(_goalX + _goalW, _width); x++)
+        {
+            _dist[this->index(x, y)] = 0;
+            _queue.push_back((int)this->index(x, y));
+        }
+    }
+    for(size_t head = 0; head < _queue.size(); head++)
+    {
+        int cell = _queue[head];
+        for(int dir = 0; dir < 4; dir++)
+        {
+            int next = this->neighbour(cell, mDirection(dir));
+            if(next >= 0 && _dist[next] == UNREACHABLE)
+            {
+                _dist[next] = _dist[cell] + 1;
+                _queue.push_back(next);
+            }
+        }
+    }
+}
+
+void floodPlanner::senseCell(int x, int y, int walls)
+{
+    size_t cell = this->index(x, y);
+    _explored[cell >> 6] |= (uint64_t)1 << (cell & 63);
+    for(int dir = 0; dir < 4; dir++)
+    {
+        if(walls & (1 << dir))
+        {
+            this->addWall(x, y, mDirection(dir));
+        }
+    }
+}
+
+//A new wall can only make cells further away. First every cell that lost its way
+//downhill is cleared, along with whatever leaned on it, then the cleared cells are
+//filled back in from the cells around them that were still right, closest first
+bool floodPlanner::addWall(int x, int y, mDirection dir)
+{
+    int nx = x + floodDX[dir], ny = y + floodDY[dir];
+    if(!this->isOpen(x, y, dir) || nx < 0 || ny < 0 || nx >= _width || ny >= _height)
+    {
+        return false;
+    }
+    _walls.setWall(x, y, floodWall[dir], true);
+
+    _affected.clear();
+    _stack.clear();
+    int ends[2] = {(int)this->index(x, y), (int)this->index(nx, ny)};
+    for(int i = 0; i < 2; i++)
+    {
+        int cell = ends[i];
+        if(_dist[cell] != UNREACHABLE && _dist[cell] != 0 && !this->hasSupport(cell))
+        {
+            _stack.push_back(cell);
+        }
+    }
+    if(_stack.empty())
+    {
+        return false;
+    }
+
+    //stack holds cells that just lost support, their old distance is still in _dist
+    while(!_stack.empty())
+    {
+        int cell = _stack.back();
+        _stack.pop_back();
+        if(_dist[cell] == UNREACHABLE)
+        {
+            continue;
+        }
+        uint32_t old = _dist[cell];
+        _dist[cell] = UNREACHABLE;
+        _affected.push_back(cell);
+        for(int d = 0; d < 4; d++)
+        {
+            int next = this->neighbour(cell, mDirection(d));
+            if(next >= 0 && _dist[next] == old + 1 && !this->hasSupport(next))
+            {
+                _stack.push_back(next);
+            }
+        }
+    }
+    this->repair();
+    return true;
+}
+
+//bfs over the cleared cells, started from each one's best neighbour outside them
+void floodPlanner::repair()
+{
+    _seeds.clear();
+    for(size_t i = 0; i < _affected.size(); i++)
+    {
+        int cell = _affected[i];
+        uint32_t best = UNREACHABLE;
+        for(int dir = 0; dir < 4; dir++)
+        {
+            int next = this->neighbour(cell, mDirection(dir));
+            if(next >= 0 && _dist[next] != UNREACHABLE)
+            {
+                best = std::min(best, _dist[next] + 1);
+            }
+        }
+        if(best != UNREACHABLE)
+        {
+            _seeds.push_back(std::make_pair(best, cell));
+        }
+    }
+    std::sort(_seeds.begin(), _seeds.end());
+
+    //seeds and the queue are both in distance order, always take the closer one
+    _queue.clear();
+    size_t head = 0, seed = 0;
+    while(head < _queue.size() || seed < _seeds.size())
+    {
+        int cell;
+        if(seed < _seeds.size() && (head == _queue.size() || _seeds[seed].first < _dist[_queue[head]]))
+        {
+            cell = _seeds[seed].second;
+            uint32_t d = _seeds[seed++].first;
+            if(d >= _dist[cell])
+            {
+                continue;
+            }
+            _dist[cell] = d;
+        }
+        else
+        {
+            cell = _queue[head++];
+        }
+        for(int dir = 0; dir < 4; dir++)
+        {
+            int next = this->neighbour(cell, mDirection(dir));
+            if(next >= 0 && _dist[next] > _dist[cell] + 1)
+            {
+                _dist[next] = _dist[cell] + 1;
+                _queue.push_back(next);
+            }
+        }
+    }
+}
+
+bool floodPlanner::nextMove(int x, int y, mDirection heading, mDirection &dir) const
+{
+    size_t cell = this->index(x, y);
+    if(_dist[cell] == 0 || _dist[cell] == UNREACHABLE)
+    {
+        return false;
+    }
+    for(int turn = 0; turn < 4; turn++)
+    {
+        mDirection d = mDirection((heading + turn) & 3);
+        int next = this->neighbour((int)cell, d);
+        if(next >= 0 && _dist[next] + 1 == _dist[cell])
+        {
+            dir = d;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+#ifndef FLOODPLANNER_H
+#define FLOODPLANNER_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include <stdint.h>
+#include <vector>
+
+//Flood fill planner for exploring AIs. Keeps the distance from every cell to the goal
+//over the walls found so far, walls that haven't been seen yet count as open. Finding
+//a wall only repairs the cells whose distance depended on it, and the next move is a
+//look at four neighbours, so the mouse can head for the goal while it is still exploring.
+//Cells are 0 based, wall masks have bit (1 << mDirection) set for every wall.
+class floodPlanner
+{
+public:
+    floodPlanner(int width = DEFAULT_MAZE_WIDTH, int height = DEFAULT_MAZE_HEIGHT);
+
+    //forgets every wall and the goal
+    void reset(int width, int height);
+    //goal is a w x h block of cells, a contest goal room is 2x2
+    void setGoal(int x, int y, int w = 1, int h = 1);
+
+    //records what the sensors saw in a cell, walls is a mask of the walls around it
+    void senseCell(int x, int y, int walls);
+    //records one wall, true if any distance changed
+    bool addWall(int x, int y, mDirection dir);
+
+    bool isExplored(int x, int y) const { return (_explored[index(x, y) >> 6] >> (index(x, y) & 63)) & 1; }
+    bool isGoal(int x, int y) const;
+    bool isOpen(int x, int y, mDirection dir) const;
+    const baseMap &knownWalls() const { return _walls; }
+
+    //steps to the goal over the known walls, UNREACHABLE if it's walled off
+    uint32_t distance(int x, int y) const { return _dist[index(x, y)]; }
+    //downhill move from x,y, keeps going straight when that's as good. False at
+    //the goal or when the goal can't be reached
+    bool nextMove(int x, int y, mDirection heading, mDirection &dir) const;
+
+    static const uint32_t UNREACHABLE = 0xFFFFFFFFu;
+
+private:
+    size_t index(int x, int y) const { return (size_t)y*_width + x; }
+    int neighbour(int cell, mDirection dir) const;
+    bool hasSupport(int cell) const;
+    void flood();
+    void repair();
+
+    int _width, _height;
+    int _goalX, _goalY, _goalW, _goalH;
+    baseMap _walls;
+    std::vector<uint32_t> _dist;
+    std::vector<uint64_t> _explored;
+
+    //scratch for repair(), kept so sensing a wall doesn't allocate
+    std::vector<int> _stack;
+    std::vector<int> _affected;
+    std::vector<std::pair<uint32_t, int> > _seeds;
+    std::vector<int> _queue;
+};
+
+#endif // FLOODPLANNER_H
@@ -0,0 +1,98 @@
+#include "floodSolver.h"
+
+//mDirection order
+static const int stepX[4] = {1, 0, -1, 0};
+static const int stepY[4] = {0, -1, 0, 1};
+
+floodSolver::floodSolver()
+{
+    _newRun = true;
+    _x = _y = 0;
+    _heading = dUP;
+}
+
+void floodSolver::studentAI()
+{
+    //the sim says when the maze changed, the size check covers a solver moved to another sim
+    if(this->isNewMaze() || _plan.knownWalls().width() != this->mazeWidth() || _plan.knownWalls().height() != this->mazeHeight())
+    {
+        _plan.reset(this->mazeWidth(), this->mazeHeight());
+        _newRun = true;
+        if(this->goalX() >= this->mazeWidth() || this->goalY() >= this->mazeHeight())
+        {
+            this->printUI("Destination is outside the maze.");
+            this->finish();
+            return;
+        }
+        _plan.setGoal(this->goalX(), this->goalY());
+    }
+    if(_newRun)
+    {
+        _x = this->startX();
+        _y = this->startY();
+        _heading = dUP;
+        _newRun = false;
+    }
+
+    _plan.senseCell(_x, _y, this->senseWalls());
+    mDirection dir;
+    if(!_plan.nextMove(_x, _y, _heading, dir))
+    {
+        if(!_plan.isGoal(_x, _y))
+        {
+            this->printUI("Destination not reachable.");
+        }
+        this->finish();
+        return;
+    }
+    _heading = dir;
+    if(this->moveDirection(dir))
+    {
+        _x += stepX[dir];
+        _y += stepY[dir];
+    }
+}
+
+//the next tick starts a run from the start cell
+void floodSolver::finish()
+{
+    _newRun = true;
+    this->foundFinish();
+}
+
+#ifdef SOLVER_COROUTINES
+solverTask floodTaskSolver::run()
+{
+    _plan.reset(this->mazeWidth(), this->mazeHeight());
+    if(this->goalX() >= this->mazeWidth() || this->goalY() >= this->mazeHeight())
+    {
+        this->printUI("Destination is outside the maze.");
+        for(;;)
+        {
+            co_await this->foundFinish();
+        }
+    }
+    _plan.setGoal(this->goalX(), this->goalY());
+    for(;;)
+    {
+        int x = this->startX(), y = this->startY();
+        mDirection heading = dUP, dir;
+        _plan.senseCell(x, y, co_await this->senseWalls());
+        while(_plan.nextMove(x, y, heading, dir))
+        {
+            heading = dir;
+            if(co_await this->moveDirection(dir))
+            {
+                x += stepX[dir];
+                y += stepY[dir];
+            }
+            _plan.senseCell(x, y, co_await this->senseWalls());
+        }
+        if(!_plan.isGoal(x, y))
+        {
+            this->printUI("Destination not reachable.");
+        }
+        co_await this->foundFinish();
+    }
+}
+#endif
@@ -0,0 +1,42 @@
+#ifndef FLOODSOLVER_H
+#define FLOODSOLVER_H
+
+#include "mazeSolver.h"
+#include "coroutineSolver.h"
+#include "floodPlanner.h"
+
+//The usual contest strategy as a ready made solver: sense the cell, take the
+//downhill move of a floodPlanner, one move a tick. The first run explores on its
+//way to the goal, later runs go straight there over what it has learned.
+//It starts and ends where the maze says, see goalX() for mazes without a goal.
+class floodSolver : public mazeSolver
+{
+public:
+    floodSolver();
+
+protected:
+    void studentAI();
+
+private:
+    void finish();
+
+    floodPlanner _plan;
+    bool _newRun;
+    int _x, _y;
+    mDirection _heading;
+};
+
+#ifdef SOLVER_COROUTINES
+//floodSolver written as a coroutine, the same moves in the same ticks without
+//the state it needs to pick up where the last tick left off
+class floodTaskSolver : public coroutineSolver
+{
+protected:
+    solverTask run();
+
+private:
+    floodPlanner _plan;
+};
+#endif
+
+#endif // FLOODSOLVER_H
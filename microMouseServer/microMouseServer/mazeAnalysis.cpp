@@ -0,0 +1,304 @@
+#include "mazeAnalysis.h"
+
+//ways out of a cell by its wall mask
+static const int exitCount[16] = {4, 3, 3, 2, 3, 2, 2, 1, 3, 2, 2, 1, 2, 1, 1, 0};
+
+//count low bits set, for the last chunk of a row
+static inline uint64_t lowBits(int count)
+{
+    return count >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << count) - 1;
+}
+
+//index of the lowest set bit, bits isn't 0
+static inline int lowestBit(uint64_t bits)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(bits);
+#else
+    int i = 0;
+    while(!((bits >> i) & 1))
+    {
+        i++;
+    }
+    return i;
+#endif
+}
+
+mazeReport mazeAnalyzer::analyze(const baseMap &maze)
+{
+    _width = maze.width();
+    _height = maze.height();
+    mazeReport report;
+    report.width = _width;
+    report.height = _height;
+    report.hasGoal = maze.hasGoal();
+
+    //every pass after this reads the walls of a cell many times over, one mask each is quicker
+    size_t cells = (size_t)_width*_height;
+    _walls.resize(cells);
+    for(size_t c = 0; c < cells; c++)
+    {
+        _walls[c] = (uint8_t)maze.wallMask(c % _width, c / _width);
+    }
+    _step[dRIGHT] = 1;
+    _step[dDOWN] = -_width;
+    _step[dLEFT] = -1;
+    _step[dUP] = _width;
+
+    this->cellComponents(maze, report);
+    this->wallComponents(maze, report);
+    this->pruneDeadEnds(maze, report);
+
+    this->distances((int)this->index(maze.startX(), maze.startY()), _fromStart);
+    report.bestSteps = -1;
+    report.shortestPathCells = 0;
+    if(!maze.hasGoal())
+    {
+        _fromGoal.assign(cells, -1);
+        return report;
+    }
+    this->distances((int)this->index(maze.goalX(), maze.goalY()), _fromGoal);
+    report.bestSteps = this->fromStart(maze.goalX(), maze.goalY());
+    if(report.bestSteps < 0)
+    {
+        return report;
+    }
+    for(size_t c = 0; c < cells; c++)
+    {
+        report.shortestPathCells += _fromStart[c] >= 0 && _fromGoal[c] >= 0 && _fromStart[c] + _fromGoal[c] == report.bestSteps;
+    }
+    return report;
+}
+
+//roots point at themselves, path halving keeps the trees flat
+int mazeAnalyzer::find(std::vector<int> &parent, int i)
+{
+    while(parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+//the lower root wins, so a component's number is its lowest member
+bool mazeAnalyzer::join(std::vector<int> &parent, int a, int b)
+{
+    a = find(parent, a);
+    b = find(parent, b);
+    if(a == b)
+    {
+        return false;
+    }
+    if(a < b)
+    {
+        parent[b] = a;
+    }
+    else
+    {
+        parent[a] = b;
+    }
+    return true;
+}
+
+//joins the cells either side of every open wall, 64 walls of a row at a time
+void mazeAnalyzer::cellComponents(const baseMap &maze, mazeReport &report)
+{
+    size_t cells = (size_t)_width*_height;
+    _cell.resize(cells);
+    for(size_t c = 0; c < cells; c++)
+    {
+        _cell[c] = (int)c;
+    }
+    for(int y = 0; y < _height; y++)
+    {
+        int row = y*_width;
+        for(int chunk = 0; chunk*64 < _width; chunk++)
+        {
+            uint64_t open = ~maze.rowV(y, chunk) & lowBits(_width-1 - chunk*64);
+            while(open)
+            {
+                int x = chunk*64 + lowestBit(open);
+                join(_cell, row + x, row + x + 1);
+                open &= open - 1;
+            }
+            if(y < _height-1)
+            {
+                open = ~maze.rowH(y, chunk) & lowBits(_width - chunk*64);
+                while(open)
+                {
+                    int x = chunk*64 + lowestBit(open);
+                    join(_cell, row + x, row + x + _width);
+                    open &= open - 1;
+                }
+            }
+        }
+    }
+
+    //flatten so component() is one read
+    report.components = 0;
+    for(size_t c = 0; c < cells; c++)
+    {
+        _cell[c] = find(_cell, (int)c);
+        report.components += _cell[c] == (int)c;
+    }
+    int start = this->component(maze.startX(), maze.startY());
+    report.unreachableCells = 0;
+    for(size_t c = 0; c < cells; c++)
+    {
+        report.unreachableCells += _cell[c] != start;
+    }
+    report.goalReachable = maze.hasGoal() && this->component(maze.goalX(), maze.goalY()) == start;
+}
+
+//Wall posts are the corners of the cells, (width+1)*(height+1) of them and post
+//py*(width+1)+px at the bottom left of cell px,py. Every wall joins the two posts
+//at its ends, the outer wall is one group with post 0 in it. A group that doesn't
+//reach post 0 is an island, a mouse keeping a hand on the wall never gets near it.
+void mazeAnalyzer::wallComponents(const baseMap &maze, mazeReport &report)
+{
+    int stride = _width + 1;
+    size_t posts = (size_t)stride*(_height + 1);
+    _post.resize(posts);
+    for(size_t p = 0; p < posts; p++)
+    {
+        _post[p] = (int)p;
+    }
+    for(int px = 0; px <= _width; px++)
+    {
+        join(_post, 0, px);
+        join(_post, 0, _height*stride + px);
+    }
+    for(int py = 0; py <= _height; py++)
+    {
+        join(_post, 0, py*stride);
+        join(_post, 0, py*stride + _width);
+    }
+
+    //only inside walls are stored, so only those can start an island
+    _walled.assign(posts, 0);
+    for(int y = 0; y < _height; y++)
+    {
+        for(int chunk = 0; chunk*64 < _width; chunk++)
+        {
+            //right of x,y: posts x+1,y and x+1,y+1
+            uint64_t walls = maze.rowV(y, chunk);
+            while(walls)
+            {
+                int a = y*stride + chunk*64 + lowestBit(walls) + 1;
+                join(_post, a, a + stride);
+                _walled[a] = _walled[a + stride] = 1;
+                walls &= walls - 1;
+            }
+            //above x,y: posts x,y+1 and x+1,y+1
+            walls = maze.rowH(y, chunk);
+            while(walls)
+            {
+                int a = (y + 1)*stride + chunk*64 + lowestBit(walls);
+                join(_post, a, a + 1);
+                _walled[a] = _walled[a + 1] = 1;
+                walls &= walls - 1;
+            }
+        }
+    }
+
+    //every post of a group is the end of one of its walls, so a walled root is a walled group
+    report.wallIslands = 0;
+    for(size_t p = 1; p < posts; p++)
+    {
+        report.wallIslands += _walled[p] && find(_post, (int)p) == (int)p;
+    }
+
+    //a corner post of each of the goal's walls, right and bottom from the bottom right
+    //and bottom left corners, left and top from the bottom left and top left
+    report.islanded = false;
+    if(!maze.hasGoal())
+    {
+        return;
+    }
+    int corner = maze.goalY()*stride + maze.goalX();
+    int ends[4] = {corner + 1, corner, corner, corner + stride};
+    int walls = maze.wallMask(maze.goalX(), maze.goalY());
+    report.islanded = true;
+    for(int dir = 0; dir < 4; dir++)
+    {
+        if((walls >> dir) & 1 && find(_post, ends[dir]) == 0)
+        {
+            report.islanded = false;
+        }
+    }
+}
+
+//Fills in dead ends until there are none, a cell with one way out that isn't the
+//start or goal is pruned and its neighbour may become the next dead end. What's
+//left is the loops and the ways between start and goal.
+void mazeAnalyzer::pruneDeadEnds(const baseMap &maze, mazeReport &report)
+{
+    size_t cells = (size_t)_width*_height;
+    int start = (int)this->index(maze.startX(), maze.startY());
+    int goal = maze.hasGoal() ? (int)this->index(maze.goalX(), maze.goalY()) : -1;
+    _pruned.assign(cells, 0);
+    _queue.clear();
+    report.deadEnds = 0;
+    for(size_t c = 0; c < cells; c++)
+    {
+        int exits = exitCount[_walls[c]];
+        if(exits <= 1 && (int)c != start && (int)c != goal)
+        {
+            report.deadEnds += exits == 1;
+            _pruned[c] = 1;
+            _queue.push_back((int)c);
+        }
+    }
+
+    for(size_t i = 0; i < _queue.size(); i++)
+    {
+        int c = _queue[i];
+        for(int dir = 0; dir < 4; dir++)
+        {
+            if((_walls[c] >> dir) & 1)
+            {
+                continue;
+            }
+            int n = c + _step[dir];
+            if(_pruned[n] || n == start || n == goal)
+            {
+                continue;
+            }
+            //ways out of the neighbour that haven't been filled in yet
+            int exits = 0;
+            for(int d = 0; d < 4; d++)
+            {
+                exits += !((_walls[n] >> d) & 1) && !_pruned[n + _step[d]];
+            }
+            if(exits <= 1)
+            {
+                _pruned[n] = 1;
+                _queue.push_back(n);
+            }
+        }
+    }
+    report.deadEndCells = (int)_queue.size();
+}
+
+//plain BFS, every step costs the same
+void mazeAnalyzer::distances(int from, std::vector<int> &dist)
+{
+    dist.assign((size_t)_width*_height, -1);
+    _queue.clear();
+    dist[from] = 0;
+    _queue.push_back(from);
+    for(size_t i = 0; i < _queue.size(); i++)
+    {
+        int c = _queue[i];
+        for(int dir = 0; dir < 4; dir++)
+        {
+            int n = c + _step[dir];
+            if(!((_walls[c] >> dir) & 1) && dist[n] < 0)
+            {
+                dist[n] = dist[c] + 1;
+                _queue.push_back(n);
+            }
+        }
+    }
+}
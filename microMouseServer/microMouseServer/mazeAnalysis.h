@@ -0,0 +1,65 @@
+#ifndef MAZEANALYSIS_H
+#define MAZEANALYSIS_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include <stdint.h>
+#include <vector>
+
+//what mazeAnalyzer found out about one maze. Steps are -1 when there is no goal
+//or no way to it
+struct mazeReport
+{
+    int width, height;
+    int components;         //groups of cells joined by open walls
+    int unreachableCells;   //cells the start can't get to
+    bool hasGoal;
+    bool goalReachable;
+    int wallIslands;        //groups of walls that don't touch the outer wall
+    bool islanded;          //the goal doesn't touch the outer wall, following a wall never finds it
+    int deadEnds;           //cells with one way out, start and goal not counted
+    int deadEndCells;       //cells pruned by filling dead ends in until none are left
+    int bestSteps;          //shortest start to goal
+    int shortestPathCells;  //cells on at least one shortest path, start and goal included
+};
+
+//Offline analysis of a whole known maze, for sorting out submitted mazes before
+//they are run and for scoring a run against the best it could have done. Every
+//part is one linear pass: union-find over the cells and over the wall posts, a
+//queue that fills in dead ends, and a BFS each from start and goal.
+//Cells are 0 based. Scratch memory is kept between calls, use one per thread.
+class mazeAnalyzer
+{
+public:
+    mazeReport analyze(const baseMap &maze);
+
+    //per cell results of the last analyze()
+    //cells with the same component are joined, the numbers mean nothing else
+    int component(int x, int y) const { return _cell[index(x, y)]; }
+    bool isDeadEnd(int x, int y) const { return _pruned[index(x, y)] != 0; }
+    //BFS steps, -1 if it can't be reached
+    int fromStart(int x, int y) const { return _fromStart[index(x, y)]; }
+    int fromGoal(int x, int y) const { return _fromGoal[index(x, y)]; }
+
+private:
+    size_t index(int x, int y) const { return (size_t)y*_width + x; }
+    static int find(std::vector<int> &parent, int i);
+    static bool join(std::vector<int> &parent, int a, int b);
+    void cellComponents(const baseMap &maze, mazeReport &report);
+    void wallComponents(const baseMap &maze, mazeReport &report);
+    void pruneDeadEnds(const baseMap &maze, mazeReport &report);
+    void distances(int from, std::vector<int> &dist);
+
+    int _width, _height;
+    int _step[4];                   //cell index change of a move, by mDirection
+    std::vector<uint8_t> _walls;    //wallMask() of every cell
+    std::vector<int> _cell;
+    std::vector<int> _post;
+    std::vector<uint8_t> _walled;
+    std::vector<uint8_t> _pruned;
+    std::vector<int> _fromStart;
+    std::vector<int> _fromGoal;
+    std::vector<int> _queue;
+};
+
+#endif // MAZEANALYSIS_H
@@ -0,0 +1,188 @@
+//mazeAnalyze - checks mazes before any time is spent running them, on every core.
+//Connected parts, wall islands, dead ends and the shortest way from start to goal.
+//
+//usage: mazeAnalyze [-j threads] [--goal x,y] [--csv] <dir|file|glob>...
+//       mazeAnalyze [options] --generate n [mazeGen options]
+//
+//A maze is ok when its goal can be reached from the start. Mazes that don't say
+//where their goal is get the solvers' default, 12,8. The exit code is 2 if any maze
+//isn't ok or didn't load, a maze too small for the default goal is only reported.
+
+#include "mazeAnalysis.h"
+#include "mazeIO.h"
+#include "mazeGenerator.h"
+#include "taskPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct analyzeResult
+{
+    mazeError error;
+    mazeReport report;
+};
+
+static void usage()
+{
+    fprintf(stderr, "usage: mazeAnalyze [-j threads] [--goal x,y] [--csv] <dir|file|glob>...\n"
+                    "       mazeAnalyze [options] --generate n [--algorithm a] [--size WxH] [--start x,y] [--maze-goal x,y]\n"
+                    "                   [--braid p] [--islanded] [--seed n]\n");
+}
+
+static const char *verdict(const mazeReport &r)
+{
+    if(r.bestSteps < 0)
+    {
+        return r.hasGoal ? "goal unreachable" : "n/a, no goal";
+    }
+    return r.unreachableCells ? "ok, walled off cells" : "ok";
+}
+
+int main(int argc, char *argv[])
+{
+    int threads = 0;
+    int goalX = 0, goalY = 0;
+    bool goalGiven = false;
+    bool csv = false;
+    long generate = 0;
+    mazeGenOptions genOptions;
+    std::vector<std::string> files;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool ok;
+        if(parseGenOption(argc, argv, i, genOptions, ok))
+        {
+            if(!ok)
+            {
+                usage();
+                return 1;
+            }
+        }
+        else if(!strcmp(argv[i], "--generate") && i + 1 < argc)
+        {
+            generate = atol(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "-j") && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--goal") && i + 1 < argc)
+        {
+            if(!parseMazeCell(argv[++i], goalX, goalY))
+            {
+                usage();
+                return 1;
+            }
+            goalGiven = true;
+        }
+        else if(!strcmp(argv[i], "--csv"))
+        {
+            csv = true;
+        }
+        else if(argv[i][0] == '-')
+        {
+            usage();
+            return 1;
+        }
+        else if(!findMazeFiles(argv[i], files))
+        {
+            fprintf(stderr, "no maze files match %s\n", argv[i]);
+        }
+    }
+    //generated mazes are named by their index like in mazeBatch
+    for(long i = 0; i < generate; i++)
+    {
+        files.push_back("gen:" + std::to_string(i));
+    }
+    if(files.empty())
+    {
+        usage();
+        return 1;
+    }
+
+    std::vector<analyzeResult> results(files.size());
+    taskPool pool(threads);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    pool.run((int)files.size(), [&](int i) {
+        analyzeResult &r = results[i];
+        static thread_local baseMap maze;
+        static thread_local mazeAnalyzer analyzer;
+        if(i >= (int)files.size() - generate)
+        {
+            static thread_local mazeGenerator generator(genOptions);
+            generator.generate(i - (files.size() - generate), maze);
+            r.error = MAZE_OK;
+        }
+        else
+        {
+            r.error = readMaze(files[i].c_str(), maze);
+        }
+        if(r.error != MAZE_OK)
+        {
+            return;
+        }
+        //1 based like mazeBatch, a maze it doesn't fit in can't be run against it
+        if(goalGiven)
+        {
+            if(goalX > maze.width() || goalY > maze.height())
+            {
+                r.error = MAZE_ERR_GOAL_OUTSIDE;
+                return;
+            }
+            maze.setGoal(goalX - 1, goalY - 1);
+        }
+        useDefaultGoal(maze);
+        r.report = analyzer.analyze(maze);
+    });
+
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    int good = 0;
+    if(csv)
+    {
+        printf("maze,width,height,components,unreachable_cells,goal_reachable,wall_islands,islanded,dead_ends,dead_end_cells,best_steps,shortest_path_cells\n");
+    }
+    else
+    {
+        printf("%-32s %9s %6s %11s %7s %8s %9s %9s %6s %7s  %s\n", "maze", "size", "parts", "unreachable",
+               "islands", "islanded", "dead ends", "pruned", "best", "on best", "verdict");
+    }
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        analyzeResult &r = results[i];
+        if(r.error != MAZE_OK)
+        {
+            if(!csv)
+            {
+                printf("%-32s %s\n", files[i].c_str(), mazeErrorString(r.error));
+            }
+            continue;
+        }
+        const mazeReport &m = r.report;
+        good += m.bestSteps >= 0 || !m.hasGoal;
+        if(csv)
+        {
+            printf("%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n", files[i].c_str(), m.width, m.height, m.components,
+                   m.unreachableCells, m.goalReachable, m.wallIslands, m.islanded, m.deadEnds, m.deadEndCells,
+                   m.bestSteps, m.shortestPathCells);
+            continue;
+        }
+        char size[24], best[16] = "-";
+        snprintf(size, sizeof(size), "%dx%d", m.width, m.height);
+        if(m.bestSteps >= 0)
+        {
+            snprintf(best, sizeof(best), "%d", m.bestSteps);
+        }
+        printf("%-32s %9s %6d %11d %7d %8s %9d %9d %6s %7d  %s\n", files[i].c_str(), size, m.components,
+               m.unreachableCells, m.wallIslands, m.islanded ? "yes" : "no", m.deadEnds, m.deadEndCells,
+               best, m.shortestPathCells, verdict(m));
+    }
+    fprintf(csv ? stderr : stdout, "%d/%d ok in %.3f ms on %d threads\n", good, (int)files.size(), totalMs, pool.threadCount());
+
+    return good == (int)files.size() ? 0 : 2;
+}
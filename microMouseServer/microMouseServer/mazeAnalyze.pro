@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Maze checker for submitted mazes and corpora, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console thread
+CONFIG   -= app_bundle qt
+
+TARGET = mazeAnalyze
+TEMPLATE = app
+
+include(simCore.pri)
+
+SOURCES += mazeAnalyze.cpp \
+    taskPool.cpp
+
+HEADERS += taskPool.h
@@ -1,75 +1,239 @@
 #include "mazeBase.h"
+#include <algorithm>
 
-baseMapNode::baseMapNode()
+baseMap::baseMap(int width, int height)
 {
-    this->_bottom=NULL;
-    this->_top=NULL;
-    this->_left=NULL;
-    this->_right=NULL;
-    this->_x =0;
-    this->_y =0;
+    this->resize(width, height);
 }
 
-int baseMapNode::posX()
+baseMap::baseMap(const baseMap &other)
 {
+    *this = other;
+}
+
+baseMap &baseMap::operator=(const baseMap &other)
+{
+    _width = other._width;
+    _height = other._height;
+    _startX = other._startX;
+    _startY = other._startY;
+    _goalX = other._goalX;
+    _goalY = other._goalY;
+    _store = other._store;
+    _mapping = other._mapping;
+    if(_mapping)
+    {
+        _v = other._v;
+        _h = other._h;
+    }
+    else
+    {
+        _v = _store.data();
+        _h = _v + vWords(_width, _height);
+    }
+    return *this;
+}
 
-    return this->_x;
+//the vectors swap their buffers, so _v and _h still point at the right words
+void baseMap::swap(baseMap &other)
+{
+    std::swap(_width, other._width);
+    std::swap(_height, other._height);
+    std::swap(_startX, other._startX);
+    std::swap(_startY, other._startY);
+    std::swap(_goalX, other._goalX);
+    std::swap(_goalY, other._goalY);
+    std::swap(_v, other._v);
+    std::swap(_h, other._h);
+    _store.swap(other._store);
+    _mapping.swap(other._mapping);
 }
 
-int baseMapNode::posY()
+void baseMap::resize(int width, int height)
 {
-    return this->_y;
+    _width = width;
+    _height = height;
+    _startX = 0;
+    _startY = 0;
+    _goalX = -1;
+    _goalY = -1;
+    _mapping.reset();
+
+    //both edge sets in one block, v then h. Always at least one word each so the
+    //outside walls can read bit 0 even when a 1 wide maze stores nothing
+    _store.assign(vWords(width, height) + hWords(width, height), 0);
+    _v = _store.data();
+    _h = _v + vWords(width, height);
 }
-bool baseMapNode::isWallTop()
+
+void baseMap::adopt(int width, int height, const uint64_t *v, const uint64_t *h, std::shared_ptr<const void> mapping)
+{
+    _width = width;
+    _height = height;
+    _startX = 0;
+    _startY = 0;
+    _goalX = -1;
+    _goalY = -1;
+    _store.clear();
+    _mapping = mapping;
+    _v = v;
+    _h = h;
+}
+
+//copy mapped walls into our own storage before the first edit
+void baseMap::detach()
 {
-    return this->_top?0:1;
+    size_t nv = vWords(_width, _height), nh = hWords(_width, _height);
+    std::vector<uint64_t> words(nv + nh);
+    std::copy(_v, _v + nv, words.begin());
+    std::copy(_h, _h + nh, words.begin() + nv);
+    _store.swap(words);
+    _mapping.reset();
+    _v = _store.data();
+    _h = _v + nv;
 }
-bool baseMapNode::isWallLeft()
+
+uint64_t *baseMap::mutableWordsV()
 {
-    return this->_left?0:1;
+    if(_mapping)
+    {
+        this->detach();
+    }
+    return _store.data();
 }
-bool baseMapNode::isWallRight()
+
+uint64_t *baseMap::mutableWordsH()
 {
-    return this->_right?0:1;
+    if(_mapping)
+    {
+        this->detach();
+    }
+    return _store.data() + vWords(_width, _height);
 }
-bool baseMapNode::isWallBottom()
+
+void baseMap::clear()
 {
-    return this->_bottom?0:1;
+    if(_mapping)
+    {
+        this->detach();
+    }
+    std::fill(_store.begin(), _store.end(), 0);
 }
 
-void baseMapNode::setX(int val)
+void baseMap::setStart(int x, int y)
 {
-    this->_x = val;
+    _startX = x;
+    _startY = y;
 }
 
-void baseMapNode::setY(int val)
+void baseMap::setGoal(int x, int y)
 {
-   this->_y = val;
+    _goalX = x;
+    _goalY = y;
 }
 
-void baseMapNode::setXY(int valX, int valY)
+bool baseMap::isWall(int x, int y, Wall pos) const
 {
-    this->_x = valX;
-    this->_y = valY;
+    switch(pos)
+    {
+    case TOP:
+        return isWallTop(x, y);
+    case BOTTOM:
+        return isWallBottom(x, y);
+    case LEFT:
+        return isWallLeft(x, y);
+    case RIGHT:
+        return isWallRight(x, y);
+    }
+    return true;
 }
 
-void baseMapNode::setWall(Wall pos, baseMapNode *addr)
+void baseMap::setWall(int x, int y, Wall pos, bool isWall)
 {
-    if(pos == TOP)
+    size_t i;
+    uint64_t *words;
+
+    if(x < 0 || y < 0 || x >= _width || y >= _height)
+    {
+        return;
+    }
+
+    if(_mapping)
+    {
+        this->detach();
+    }
+
+    //walls on the outside of the maze can't be removed
+    if(pos == TOP && y < _height-1)
+    {
+        words = _store.data() + vWords(_width, _height);
+        i = (size_t)y*_width+x;
+    }
+    else if(pos == BOTTOM && y > 0)
+    {
+        words = _store.data() + vWords(_width, _height);
+        i = (size_t)(y-1)*_width+x;
+    }
+    else if(pos == LEFT && x > 0)
+    {
+        words = _store.data();
+        i = (size_t)y*(_width-1)+x-1;
+    }
+    else if(pos == RIGHT && x < _width-1)
+    {
+        words = _store.data();
+        i = (size_t)y*(_width-1)+x;
+    }
+    else
+    {
+        return;
+    }
+
+    uint64_t mask = (uint64_t)1 << (i & 63);
+    if(isWall)
     {
-        this->_top = addr;
+        words[i >> 6] |= mask;
     }
-    else if(pos == BOTTOM)
+    else
     {
-        this->_bottom = addr;
+        words[i >> 6] &= ~mask;
     }
-    else if(pos == LEFT)
+}
+
+uint64_t baseMap::bits(const uint64_t *words, size_t pos, int count)
+{
+    if(count <= 0)
+    {
+        return 0;
+    }
+
+    //a row can straddle two words
+    size_t word = pos >> 6;
+    int shift = pos & 63;
+    uint64_t out = words[word] >> shift;
+    if(shift && shift + count > 64)
     {
-        this->_left = addr;
+        out |= words[word + 1] << (64 - shift);
     }
-    else if(pos == RIGHT)
+    if(count < 64)
     {
-        this->_right = addr;
+        out &= ((uint64_t)1 << count) - 1;
     }
+    return out;
+}
+
+uint64_t baseMap::rowV(int y, int chunk) const
+{
+    int count = _width-1 - chunk*64;
+    return bits(_v, (size_t)y*(_width-1) + chunk*64, count < 64 ? count : 64);
+}
 
+uint64_t baseMap::rowH(int y, int chunk) const
+{
+    if(y >= _height-1)
+    {
+        return 0;
+    }
+    int count = _width - chunk*64;
+    return bits(_h, (size_t)y*_width + chunk*64, count < 64 ? count : 64);
 }
@@ -2,30 +2,141 @@
 #define MAZE_BASE_H
 
 #include"mazeConst.h"
-#include<QGraphicsLineItem>
+#include<stddef.h>
+#include<stdint.h>
+#include<memory>
+#include<vector>
 enum Wall {TOP,BOTTOM,LEFT,RIGHT};
 
+//Packed maze. Every wall between two cells is one bit and is stored exactly once,
+//the outside of the maze is always a wall and isn't stored at all.
+//  _v: walls between (x,y) and (x+1,y), width-1 bits per row
+//  _h: walls between (x,y) and (x,y+1), width bits per row
+//Cells are 0 based here, posX/posY on a node are 1 based like the maze files.
+//The words either live in the map itself or in a mapped .mazb file, a mapped maze
+//is shared between copies and gets copied out the first time a wall is edited.
+
+class baseMap;
+
+//read only view of one cell, lets the old mazeData[x][y].isWallTop() style code keep working
 class baseMapNode
 {
+public:
+    baseMapNode(const baseMap *map, int x, int y) : _map(map), _x(x), _y(y) {}
+
+    int posX() const { return _x + 1; }
+    int posY() const { return _y + 1; }
+    inline bool isWallTop() const;
+    inline bool isWallLeft() const;
+    inline bool isWallRight() const;
+    inline bool isWallBottom() const;
+
 private:
+    const baseMap *_map;
     int _x,_y;
-    struct baseMapNode *_top, *_bottom, *_left, *_right;
+};
 
+class baseMapColumn
+{
 public:
-    baseMapNode();
-
-
-    int posX();
-    int posY();
-    bool isWallTop();
-    bool isWallLeft();
-    bool isWallRight();
-    bool isWallBottom();
-    void setX(int val);
-    void setY(int val);
-    void setXY(int valX,int valY);
-    void setWall(Wall pos, baseMapNode *addr);
-    void clearWall(Wall pos);
+    baseMapColumn(const baseMap *map, int x) : _map(map), _x(x) {}
+    baseMapNode operator[](int y) const { return baseMapNode(_map, _x, y); }
+
+private:
+    const baseMap *_map;
+    int _x;
 };
 
+class baseMap
+{
+public:
+    baseMap(int width = DEFAULT_MAZE_WIDTH, int height = DEFAULT_MAZE_HEIGHT);
+    baseMap(const baseMap &other);
+    baseMap &operator=(const baseMap &other);
+    //trades everything including the wall storage, nothing is copied or allocated
+    void swap(baseMap &other);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    //start and goal cells, the goal is -1,-1 when the maze doesn't say
+    int startX() const { return _startX; }
+    int startY() const { return _startY; }
+    int goalX() const { return _goalX; }
+    int goalY() const { return _goalY; }
+    bool hasGoal() const { return _goalX >= 0; }
+    void setStart(int x, int y);
+    void setGoal(int x, int y);
+
+    void resize(int width, int height);
+    void clear();
+    void setWall(int x, int y, Wall pos, bool isWall);
+    bool isWall(int x, int y, Wall pos) const;
+
+    //the index math multiplies by the inside flag instead of branching, outside
+    //walls read bit 0 and get forced to 1 by the or
+    bool isWallTop(int x, int y) const
+    {
+        size_t inside = y < _height-1;
+        return !inside | bit(_h, ((size_t)y*_width+x)*inside);
+    }
+    bool isWallBottom(int x, int y) const
+    {
+        size_t inside = y > 0;
+        return !inside | bit(_h, ((size_t)(y-1)*_width+x)*inside);
+    }
+    bool isWallLeft(int x, int y) const
+    {
+        size_t inside = x > 0;
+        return !inside | bit(_v, ((size_t)y*(_width-1)+x-1)*inside);
+    }
+    bool isWallRight(int x, int y) const
+    {
+        size_t inside = x < _width-1;
+        return !inside | bit(_v, ((size_t)y*(_width-1)+x)*inside);
+    }
+    //all four walls of a cell in one go, bit (1 << mDirection) set for each wall
+    int wallMask(int x, int y) const
+    {
+        return this->isWallRight(x, y) | this->isWallBottom(x, y) << 1 | this->isWallLeft(x, y) << 2 | this->isWallTop(x, y) << 3;
+    }
+
+    //64 wall bits at a time out of one row, bit i is the wall right of cell chunk*64+i
+    //(rowV) or above cell chunk*64+i (rowH). Bits past the end of the row are 0
+    uint64_t rowV(int y, int chunk = 0) const;
+    uint64_t rowH(int y, int chunk = 0) const;
+
+    baseMapColumn operator[](int x) const { return baseMapColumn(this, x); }
+
+    //raw wall words for the file formats, vWords()/hWords() long
+    static size_t vWords(int width, int height) { return (size_t)(width-1)*height/64 + 1; }
+    static size_t hWords(int width, int height) { return (size_t)width*(height-1)/64 + 1; }
+    const uint64_t *wordsV() const { return _v; }
+    const uint64_t *wordsH() const { return _h; }
+    //writable words for code that fills a whole maze at once, copies out a mapped maze first
+    uint64_t *mutableWordsV();
+    uint64_t *mutableWordsH();
+
+    //use wall words that live somewhere else (a mapped file) without copying them,
+    //mapping keeps that memory alive for as long as any copy of this map uses it
+    void adopt(int width, int height, const uint64_t *v, const uint64_t *h, std::shared_ptr<const void> mapping);
+
+private:
+    static bool bit(const uint64_t *words, size_t i) { return (words[i >> 6] >> (i & 63)) & 1; }
+    static uint64_t bits(const uint64_t *words, size_t pos, int count);
+    void detach();
+
+    int _width, _height;
+    int _startX, _startY, _goalX, _goalY;
+    const uint64_t *_v;
+    const uint64_t *_h;
+    std::vector<uint64_t> _store;
+    std::shared_ptr<const void> _mapping;
+};
+
+bool baseMapNode::isWallTop() const { return _map->isWallTop(_x, _y); }
+bool baseMapNode::isWallLeft() const { return _map->isWallLeft(_x, _y); }
+bool baseMapNode::isWallRight() const { return _map->isWallRight(_x, _y); }
+bool baseMapNode::isWallBottom() const { return _map->isWallBottom(_x, _y); }
+
 #endif
@@ -0,0 +1,320 @@
+//mazeBatch - runs studentAI() headless over a set of .maz/.mazb files on every core
+//
+//usage: mazeBatch [-j threads] [--max-ticks n] [--goal x,y] [--solver name | --plugin file.so] [--ai-output] [--trace dir] [--stats file] [--robot link] <dir|file|glob>...
+//       mazeBatch [options] --generate n [mazeGen options]   runs on n generated mazes without touching the disk
+
+#include "mazeSolver.h"
+#include "solverPlugin.h"
+#include "mazeIO.h"
+#include "mazeGenerator.h"
+#include "pathSearch.h"
+#include "runTrace.h"
+#include "runStats.h"
+#include "robotLink.h"
+#include "taskPool.h"
+#include "nullBuffer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct batchResult
+{
+    mazeError error;
+    runStats stats;
+    int best;           //shortest start to goal in steps, -1 without a goal or a way there
+    bool finished;      //foundFinish() was called, solved only if that was on the goal
+    bool solved;
+    double ms;
+};
+
+static void usage()
+{
+    fprintf(stderr, "usage: mazeBatch [-j threads] [--max-ticks n] [--goal x,y] [--solver name | --plugin file.so] [--ai-output] [--trace dir] [--stats file] [--robot link] <dir|file|glob>...\n"
+                    "       mazeBatch [options] --generate n [--algorithm a] [--size WxH] [--start x,y] [--maze-goal x,y]\n"
+                    "                 [--braid p] [--islanded] [--seed n]\n");
+}
+
+//<dir>/<maze file name without the extension>.mtr
+static std::string traceName(const char *dir, const std::string &mazeFile)
+{
+    std::string name = mazeFile.substr(mazeFile.find_last_of("/:") + 1);
+    return std::string(dir) + "/" + name.substr(0, name.find_last_of('.')) + ".mtr";
+}
+
+//every maze that loaded into one file, csv or else a JSON array
+static bool writeStats(const char *fileName, const std::vector<std::string> &files, const std::vector<batchResult> &results)
+{
+    size_t length = strlen(fileName);
+    bool csv = length >= 4 && !strcmp(fileName + length - 4, ".csv");
+    FILE *file = fopen(fileName, "w");
+    if(!file)
+    {
+        return false;
+    }
+    if(csv)
+    {
+        writeStatsCsvHeader(file);
+    }
+    else
+    {
+        fprintf(file, "[");
+    }
+    bool first = true;
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        if(results[i].error != MAZE_OK)
+        {
+            continue;
+        }
+        if(csv)
+        {
+            writeStatsCsv(file, files[i].c_str(), results[i].stats);
+        }
+        else
+        {
+            fprintf(file, first ? "\n  " : ",\n  ");
+            writeStatsJson(file, files[i].c_str(), results[i].stats);
+        }
+        first = false;
+    }
+    if(!csv)
+    {
+        fprintf(file, "\n]\n");
+    }
+    return fclose(file) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int threads = 0;
+    long maxTicks = 1000000;
+    int goalX = 0, goalY = 0;
+    bool goalGiven = false;
+    bool aiOutput = false;
+    const char *traceDir = NULL;
+    const char *statsFile = NULL;
+    const char *robotSpec = NULL;
+    const solverEntry *solver = NULL;
+    solverPlugin plugin;
+    long generate = 0;
+    mazeGenOptions genOptions;
+    std::vector<std::string> files;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool ok;
+        if(parseGenOption(argc, argv, i, genOptions, ok))
+        {
+            if(!ok)
+            {
+                usage();
+                return 1;
+            }
+        }
+        else if(!strcmp(argv[i], "--generate") && i + 1 < argc)
+        {
+            generate = atol(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "-j") && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--max-ticks") && i + 1 < argc)
+        {
+            maxTicks = atol(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--goal") && i + 1 < argc)
+        {
+            if(!parseMazeCell(argv[++i], goalX, goalY))
+            {
+                usage();
+                return 1;
+            }
+            goalGiven = true;
+        }
+        else if(!strcmp(argv[i], "--trace") && i + 1 < argc)
+        {
+            traceDir = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--stats") && i + 1 < argc)
+        {
+            statsFile = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--robot") && i + 1 < argc)
+        {
+            robotSpec = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--solver") && i + 1 < argc)
+        {
+            solver = findSolver(argv[++i]);
+            if(!solver)
+            {
+                fprintf(stderr, "no solver called %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if(!strcmp(argv[i], "--plugin") && i + 1 < argc)
+        {
+            mazeError err = plugin.load(argv[++i]);
+            if(err != MAZE_OK)
+            {
+                fprintf(stderr, "%s: %s %s\n", argv[i], mazeErrorString(err), plugin.error().c_str());
+                return 1;
+            }
+            solver = &plugin.entry();
+        }
+        else if(!strcmp(argv[i], "--ai-output"))
+        {
+            aiOutput = true;
+        }
+        else if(argv[i][0] == '-')
+        {
+            usage();
+            return 1;
+        }
+        else
+        {
+            if(!findMazeFiles(argv[i], files))
+            {
+                fprintf(stderr, "no maze files match %s\n", argv[i]);
+            }
+        }
+    }
+    //generated mazes are named by their index, the same options and seed give the same corpus
+    for(long i = 0; i < generate; i++)
+    {
+        files.push_back("gen:" + std::to_string(i));
+    }
+    if(files.empty())
+    {
+        usage();
+        return 1;
+    }
+
+    nullBuffer discard;
+    std::streambuf *coutBuffer = std::cout.rdbuf();
+    if(!aiOutput)
+    {
+        std::cout.rdbuf(&discard);
+    }
+
+    std::vector<batchResult> results(files.size());
+    //there is only one mouse, its mazes run one after the other
+    robotLink robot;
+    if(robotSpec)
+    {
+        mazeError err = robot.open(robotSpec);
+        if(err != MAZE_OK)
+        {
+            std::cout.rdbuf(coutBuffer);
+            fprintf(stderr, "%s: %s\n", robotSpec, mazeErrorString(err));
+            return 1;
+        }
+        threads = 1;
+    }
+
+    taskPool pool(threads);
+    std::chrono::steady_clock::time_point batchStart = std::chrono::steady_clock::now();
+
+    pool.run((int)files.size(), [&](int i) {
+        batchResult &r = results[i];
+        mazeSim sim;
+        runTrace trace;
+        std::unique_ptr<mazeSolver> own(solver ? solver->create() : NULL);
+        sim.setSolver(own.get());
+        if(i >= (int)files.size() - generate)
+        {
+            static thread_local mazeGenerator generator(genOptions);
+            generator.generate(i - (files.size() - generate), sim.mazeData);
+            sim.mazeChanged();
+            r.error = MAZE_OK;
+        }
+        else
+        {
+            r.error = readMaze(files[i].c_str(), sim.mazeData);
+        }
+        if(r.error != MAZE_OK)
+        {
+            return;
+        }
+        //1 based, a maze it doesn't fit in can't be run against it
+        if(goalGiven)
+        {
+            if(goalX > sim.mazeData.width() || goalY > sim.mazeData.height())
+            {
+                r.error = MAZE_ERR_GOAL_OUTSIDE;
+                return;
+            }
+            sim.setGoal(goalX, goalY);
+        }
+        useDefaultGoal(sim.mazeData);
+        if(traceDir)
+        {
+            sim.setTrace(&trace);
+        }
+        sim.setTiming(statsFile != NULL);
+        if(robotSpec)
+        {
+            sim.setRobot(&robot);
+        }
+        sim.resetMouse();
+
+        r.best = -1;
+        if(sim.mazeData.hasGoal())
+        {
+            static thread_local pathSearch search;
+            r.best = search.run(sim.mazeData, sim.mazeData.startX(), sim.mazeData.startY(), sim.mazeData.goalX(), sim.mazeData.goalY());
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        sim.run(maxTicks);
+        r.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        r.stats = sim.stats();
+        r.finished = sim.isFinished();
+        r.solved = sim.isSolved();
+        if(traceDir)
+        {
+            r.error = trace.write(traceName(traceDir, files[i]).c_str());
+        }
+    });
+
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart).count();
+    std::cout.rdbuf(coutBuffer);
+
+    int solved = 0;
+    printf("%-32s %10s %10s %10s %10s %7s %6s %9s %10s\n", "maze", "ticks", "steps", "turns", "sensors", "solved", "best", "robot s", "ms");
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        batchResult &r = results[i];
+        if(r.error != MAZE_OK)
+        {
+            printf("%-32s %s\n", files[i].c_str(), mazeErrorString(r.error));
+            continue;
+        }
+        solved += r.solved;
+        char best[16] = "-";
+        if(r.best >= 0)
+        {
+            snprintf(best, sizeof(best), "%d", r.best);
+        }
+        printf("%-32s %10ld %10ld %10ld %10ld %7s %6s %9.1f %10.3f\n", files[i].c_str(), r.stats.aiCalls, r.stats.moves,
+               r.stats.turns, r.stats.sensors, r.solved ? "yes" : r.finished ? "gave up" : "no", best, r.stats.runTime/1000.0, r.ms);
+    }
+    if(robotSpec)
+    {
+        printf("mouse round trips: %ld, %.0f us average, %.0f us max, %ld blocked moves\n", robot.roundTrips(),
+               robot.averageRtt(), robot.maxRtt(), robot.blockedMoves());
+    }
+    if(statsFile && !writeStats(statsFile, files, results))
+    {
+        fprintf(stderr, "can't write %s\n", statsFile);
+    }
+    printf("%d/%d solved in %.3f ms on %d threads\n", solved, (int)files.size(), totalMs, pool.threadCount());
+
+    return solved == (int)files.size() ? 0 : 2;
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Headless batch runner, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console thread
+CONFIG   -= app_bundle qt
+
+TARGET = mazeBatch
+TEMPLATE = app
+
+include(simCore.pri)
+
+SOURCES += mazeBatch.cpp \
+    taskPool.cpp
+
+HEADERS += taskPool.h
@@ -0,0 +1,460 @@
+//mazeBench - times the hot paths so changes can be compared between commits
+//
+//usage: mazeBench [--warmup n] [--reps n] [--filter text] [--format text|csv|json] [--label text] [--tmp dir]
+//
+//Every benchmark runs its warm-up repetitions untimed, then --reps timed ones, and
+//reports the min, median, mean and standard deviation of one repetition along with
+//the median time per operation. The maze view benchmarks are only built with Qt,
+//run those with -platform offscreen on a machine without a display.
+
+#include "mazeSim.h"
+#include "mazeIO.h"
+#include "mazeGenerator.h"
+#include "mazeAnalysis.h"
+#include "mazeEditor.h"
+#include "pathSearch.h"
+#include "routePlanner.h"
+#include "nullBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef QT_WIDGETS_LIB
+#include "mazegui.h"
+#include <QApplication>
+#endif
+
+enum benchFormat
+{
+    BENCH_TEXT,
+    BENCH_CSV,
+    BENCH_JSON
+};
+
+//Runs and reports one benchmark at a time. setup runs untimed before every
+//repetition, body is timed and returns how many operations it did
+class benchRunner
+{
+public:
+    benchRunner(int warmup, int reps, const char *filter, benchFormat format, const char *label)
+        : _warmup(warmup), _reps(reps), _filter(filter), _format(format), _label(label), _count(0) {}
+
+    bool wanted(const std::string &name) const { return !_filter || name.find(_filter) != std::string::npos; }
+    void begin();
+    void run(const std::string &name, int size, const std::function<void()> &setup, const std::function<long()> &body);
+    void end();
+
+private:
+    int _warmup, _reps;
+    const char *_filter;
+    benchFormat _format;
+    const char *_label;
+    int _count;
+};
+
+void benchRunner::begin()
+{
+    if(_format == BENCH_TEXT)
+    {
+        printf("%-28s %6s %10s %12s %12s %12s %10s %12s\n", "benchmark", "size", "ops", "min us", "median us", "mean us", "stddev %", "ns/op");
+    }
+    else if(_format == BENCH_CSV)
+    {
+        printf("label,benchmark,size,reps,ops,min_ns,median_ns,mean_ns,stddev_ns,ns_per_op\n");
+    }
+    else
+    {
+        printf("[");
+    }
+}
+
+void benchRunner::run(const std::string &name, int size, const std::function<void()> &setup, const std::function<long()> &body)
+{
+    if(!this->wanted(name))
+    {
+        return;
+    }
+
+    long ops = 0;
+    std::vector<double> ns;
+    for(int rep = 0; rep < _warmup + _reps; rep++)
+    {
+        if(setup)
+        {
+            setup();
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ops = body();
+        double took = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if(rep >= _warmup)
+        {
+            ns.push_back(took);
+        }
+    }
+
+    std::sort(ns.begin(), ns.end());
+    double median = ns.size() & 1 ? ns[ns.size()/2] : (ns[ns.size()/2 - 1] + ns[ns.size()/2]) / 2;
+    double mean = 0, var = 0;
+    for(size_t i = 0; i < ns.size(); i++)
+    {
+        mean += ns[i];
+    }
+    mean /= ns.size();
+    for(size_t i = 0; i < ns.size(); i++)
+    {
+        var += (ns[i] - mean)*(ns[i] - mean);
+    }
+    double stddev = ns.size() > 1 ? sqrt(var / (ns.size() - 1)) : 0;
+    double perOp = ops > 0 ? median / ops : median;
+
+    if(_format == BENCH_TEXT)
+    {
+        printf("%-28s %6d %10ld %12.1f %12.1f %12.1f %10.1f %12.2f\n", name.c_str(), size, ops,
+               ns[0] / 1000, median / 1000, mean / 1000, mean > 0 ? 100*stddev/mean : 0, perOp);
+    }
+    else if(_format == BENCH_CSV)
+    {
+        printf("%s,%s,%d,%d,%ld,%.0f,%.0f,%.0f,%.0f,%.3f\n", _label, name.c_str(), size, _reps, ops,
+               ns[0], median, mean, stddev, perOp);
+    }
+    else
+    {
+        printf("%s\n  {\"label\": \"%s\", \"benchmark\": \"%s\", \"size\": %d, \"reps\": %d, \"ops\": %ld, "
+               "\"min_ns\": %.0f, \"median_ns\": %.0f, \"mean_ns\": %.0f, \"stddev_ns\": %.0f, \"ns_per_op\": %.3f}",
+               _count ? "," : "", _label, name.c_str(), size, _reps, ops, ns[0], median, mean, stddev, perOp);
+    }
+    _count++;
+    fflush(stdout);
+}
+
+void benchRunner::end()
+{
+    if(_format == BENCH_JSON)
+    {
+        printf("\n]\n");
+    }
+}
+
+//the example AI prints once its path is worked out, that splits its run in two
+class phaseListener : public simListener
+{
+public:
+    phaseListener() : printed(false) {}
+    void simPrint(const char *) { printed = true; }
+    void simFinished() {}
+
+    bool printed;
+};
+
+//the student api is private to mazeSim, mazeSim lets this one class in to time it
+class sensorBench
+{
+public:
+    typedef bool (mazeSim::*sensor)();
+
+    //every cell of the maze in turn, facing all four ways
+    static long walk(mazeSim &sim, sensor read, int rounds)
+    {
+        long calls = 0, walls = 0;
+        for(int r = 0; r < rounds; r++)
+        {
+            for(sim._y = 0; sim._y < sim.mazeData.height(); sim._y++)
+            {
+                for(sim._x = 0; sim._x < sim.mazeData.width(); sim._x++)
+                {
+                    sim._dir = mDirection((sim._x + sim._y + r) & 3);
+                    walls += (sim.*read)();
+                    calls++;
+                }
+            }
+        }
+        _sink = _sink + walls;
+        return calls;
+    }
+
+    static long walkCells(mazeSim &sim, int rounds)
+    {
+        long calls = 0, walls = 0;
+        for(int r = 0; r < rounds; r++)
+        {
+            for(sim._y = 0; sim._y < sim.mazeData.height(); sim._y++)
+            {
+                for(sim._x = 0; sim._x < sim.mazeData.width(); sim._x++)
+                {
+                    walls += sim.senseWalls();
+                    calls++;
+                }
+            }
+        }
+        _sink = _sink + walls;
+        return calls;
+    }
+
+    static sensor forward() { return &mazeSim::isWallForward; }
+    static sensor left() { return &mazeSim::isWallLeft; }
+    static sensor right() { return &mazeSim::isWallRight; }
+
+    //keeps the sensor results alive so the loops aren't optimised away
+    static volatile long _sink;
+};
+
+volatile long sensorBench::_sink = 0;
+
+static mazeGenOptions sizedOptions(int size)
+{
+    mazeGenOptions options;
+    options.width = size;
+    options.height = size;
+    options.braid = 0.3;
+    return options;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: mazeBench [--warmup n] [--reps n] [--filter text] [--format text|csv|json] [--label text] [--tmp dir]\n");
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef QT_WIDGETS_LIB
+    QApplication app(argc, argv);
+#endif
+    int warmup = 3, reps = 15;
+    const char *filter = NULL;
+    const char *label = "";
+    std::string tmpDir = ".";
+    benchFormat format = BENCH_TEXT;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--warmup") && i + 1 < argc)
+        {
+            warmup = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--reps") && i + 1 < argc)
+        {
+            reps = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--filter") && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--label") && i + 1 < argc)
+        {
+            label = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--tmp") && i + 1 < argc)
+        {
+            tmpDir = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--format") && i + 1 < argc)
+        {
+            i++;
+            if(!strcmp(argv[i], "text")) format = BENCH_TEXT;
+            else if(!strcmp(argv[i], "csv")) format = BENCH_CSV;
+            else if(!strcmp(argv[i], "json")) format = BENCH_JSON;
+            else
+            {
+                usage();
+                return 1;
+            }
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if(warmup < 0 || reps < 1)
+    {
+        usage();
+        return 1;
+    }
+
+    nullBuffer discard;
+    std::streambuf *coutBuffer = std::cout.rdbuf(&discard);
+    benchRunner bench(warmup, reps, filter, format, label);
+    bench.begin();
+
+    //file formats, ops are cells
+    std::string textName = tmpDir + "/mazeBench.tmp.maz", binaryName = tmpDir + "/mazeBench.tmp.mazb";
+    const int ioSizes[] = {16, 64, 256, 1024};
+    for(int s = 0; s < 4; s++)
+    {
+        int size = ioSizes[s];
+        baseMap maze, loaded;
+        mazeGenerator(sizedOptions(size)).generate(0, maze);
+        long cells = (long)size*size;
+        mazeError err = MAZE_OK;
+
+        bench.run("save/text", size, NULL, [&]() { err = writeMazeFile(textName.c_str(), maze); return cells; });
+        bench.run("save/binary", size, NULL, [&]() { err = writeMazeBinary(binaryName.c_str(), maze); return cells; });
+        if(bench.wanted("load/text"))
+        {
+            writeMazeFile(textName.c_str(), maze);
+            bench.run("load/text", size, NULL, [&]() { err = readMazeFile(textName.c_str(), loaded); return cells; });
+        }
+        if(bench.wanted("load/binary"))
+        {
+            writeMazeBinary(binaryName.c_str(), maze);
+            bench.run("load/binary", size, NULL, [&]() { err = readMazeBinary(binaryName.c_str(), loaded); return cells; });
+        }
+        if(err != MAZE_OK)
+        {
+            std::cout.rdbuf(coutBuffer);
+            fprintf(stderr, "%s: %s\n", tmpDir.c_str(), mazeErrorString(err));
+            return 1;
+        }
+    }
+    remove(textName.c_str());
+    remove(binaryName.c_str());
+
+    //sensors, ops are calls
+    {
+        mazeSim sim;
+        mazeGenerator(sizedOptions(64)).generate(0, sim.mazeData);
+        bench.run("sensor/isWallForward", 64, NULL, [&]() { return sensorBench::walk(sim, sensorBench::forward(), 64); });
+        bench.run("sensor/isWallLeft", 64, NULL, [&]() { return sensorBench::walk(sim, sensorBench::left(), 64); });
+        bench.run("sensor/isWallRight", 64, NULL, [&]() { return sensorBench::walk(sim, sensorBench::right(), 64); });
+        bench.run("sensor/senseWalls", 64, NULL, [&]() { return sensorBench::walkCells(sim, 64); });
+    }
+
+    //planners on the whole maze, ops are cells
+    const int planSizes[] = {16, 64, 256};
+    for(int s = 0; s < 3; s++)
+    {
+        int size = planSizes[s];
+        baseMap maze;
+        mazeGenerator(sizedOptions(size)).generate(0, maze);
+        pathSearch search;
+        routePlanner planner;
+        mazeAnalyzer analyzer;
+        long cells = (long)size*size;
+        bench.run("plan/pathSearch", size, NULL, [&]() {
+            search.run(maze, maze.startX(), maze.startY(), maze.goalX(), maze.goalY());
+            return cells;
+        });
+        bench.run("plan/routePlanner", size, NULL, [&]() {
+            planner.plan(maze, maze.startX(), maze.startY(), dUP, maze.goalX(), maze.goalY());
+            return cells;
+        });
+        bench.run("plan/mazeAnalyzer", size, NULL, [&]() {
+            analyzer.analyze(maze);
+            return cells;
+        });
+    }
+
+    //maze editor bulk edits and undoing them, ops are cells
+    const int editSizes[] = {16, 64, 256};
+    for(int s = 0; s < 3; s++)
+    {
+        int size = editSizes[s];
+        baseMap maze;
+        mazeGenerator(sizedOptions(size)).generate(0, maze);
+        mazeEditor editor;
+        editor.setMaze(&maze);
+        long cells = (long)size*size;
+        bench.run("edit/rotate", size, NULL, [&]() {
+            editor.transform(ROTATE_RIGHT);
+            return cells;
+        });
+        bench.run("edit/clearRect", size, [&]() { editor.undo(); }, [&]() {
+            editor.clearRect(0, 0, size - 1, size - 1);
+            return cells;
+        });
+        bench.run("edit/undo", size, [&]() { editor.redo(); }, [&]() {
+            editor.undo();
+            return cells;
+        });
+    }
+
+    //the example AI, ops are ticks. explore is everything up to its path being
+    //worked out, run is following that path to the end. It heads for the goal room
+    //the generator puts in the middle, a run that ends anywhere else times nothing
+    const int aiSizes[] = {16, 32, 64, 128};
+    for(int s = 0; s < 4; s++)
+    {
+        int size = aiSizes[s];
+        mazeSim sim;
+        phaseListener listener;
+        sim.setListener(&listener);
+        mazeGenerator(sizedOptions(size)).generate(0, sim.mazeData);
+        long explored = 0;
+        auto restart = [&]() {
+            sim.mazeChanged();
+            sim.resetMouse();
+            listener.printed = false;
+        };
+        auto explore = [&]() -> long {
+            while(!listener.printed && !sim.isFinished() && sim.tickCount() < 10000000)
+            {
+                sim.tick();
+            }
+            return explored = sim.tickCount();
+        };
+        bench.run("ai/explore", size, restart, explore);
+        bench.run("ai/run", size, [&]() { restart(); explore(); }, [&]() {
+            sim.run(10000000);
+            return sim.tickCount() - explored;
+        });
+        if(bench.wanted("ai/run") && !sim.isSolved())
+        {
+            std::cout.rdbuf(coutBuffer);
+            fprintf(stderr, "ai/run %d: the example AI didn't reach the goal\n", size);
+            return 1;
+        }
+    }
+
+#ifdef QT_WIDGETS_LIB
+    //maze view, ops are cells for the redraws and calls for drawMouse
+    const int guiSizes[] = {16, 64, 256};
+    for(int s = 0; s < 3; s++)
+    {
+        int size = guiSizes[s];
+        baseMap maze;
+        mazeGenerator(sizedOptions(size)).generate(0, maze);
+        long cells = (long)size*size;
+        std::unique_ptr<mazeGui> gui;
+
+        bench.run("gui/drawMaze/full", size, [&]() { gui.reset(new mazeGui); }, [&]() {
+            gui->drawMaze(maze);
+            return cells;
+        });
+
+        //a few walls change between frames, like an editor click or a replay step
+        gui.reset(new mazeGui);
+        gui->drawMaze(maze);
+        mazeRandom random(size);
+        bench.run("gui/drawMaze/incremental", size, [&]() {
+            for(int i = 0; i < 16; i++)
+            {
+                int x = random.below(size - 1), y = random.below(size);
+                maze.setWall(x, y, RIGHT, !maze.isWallRight(x, y));
+            }
+        }, [&]() {
+            gui->drawMaze(maze);
+            return cells;
+        });
+
+        bench.run("gui/drawMouse", size, NULL, [&]() {
+            for(int i = 0; i < 1024; i++)
+            {
+                gui->drawMouse(QPoint(i % size + 1, i / size % size + 1), mDirection(i & 3));
+            }
+            return 1024L;
+        });
+    }
+#endif
+
+    bench.end();
+    std::cout.rdbuf(coutBuffer);
+    return 0;
+}
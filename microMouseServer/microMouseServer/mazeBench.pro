@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Benchmarks for the hot paths, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       += core gui widgets
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TARGET = mazeBench
+TEMPLATE = app
+
+include(simCore.pri)
+
+SOURCES += mazeBench.cpp \
+    mazegui.cpp
+
+HEADERS += mazegui.h
@@ -8,11 +8,24 @@
 #ifndef MAZECONST_H_
 #define MAZECONST_H_
 #define PX_PER_UNIT 34
-#define MAZE_HEIGHT 20
-#define MAZE_WIDTH 20
-#define MAZE_HEIGHT_PX PX_PER_UNIT*MAZE_HEIGHT
-#define MAZE_WIDTH_PX PX_PER_UNIT*MAZE_WIDTH
+//maze size comes from the maze file, these are only the blank maze the editor starts with
+#define DEFAULT_MAZE_HEIGHT 20
+#define DEFAULT_MAZE_WIDTH 20
+#define MAZE_MAX_SIZE 32768
+//0 based goal for mazes that don't give one, the example AI's destination (12,8 in the maze files)
+#define DEFAULT_GOAL_X 11
+#define DEFAULT_GOAL_Y 7
 #define MDELAY 120
+//the view redraws the mouse at most this often, however fast the sim runs
+#define FRAME_RATE 60
+
+//default motion costs in ms, see motionCost in mazeSim.h. A straight run starts at
+//MOVE_CELL_MS for the first cell and gets MOVE_ACCEL_MS quicker every cell down to MOVE_FAST_CELL_MS
+#define MOVE_CELL_MS 260
+#define MOVE_FAST_CELL_MS 90
+#define MOVE_ACCEL_MS 40
+#define TURN_MS 220
+#define UTURN_MS 380
 
 #define WALL_THICKNESS_PX 2
 
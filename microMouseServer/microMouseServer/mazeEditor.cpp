@@ -0,0 +1,304 @@
+#include "mazeEditor.h"
+#include <algorithm>
+
+//16 MB of history
+static const size_t maxEdges = (size_t)1 << 22;
+
+//index of the lowest set bit, bits isn't 0
+static inline int lowestBit(uint64_t bits)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(bits);
+#else
+    int i = 0;
+    while(!((bits >> i) & 1))
+    {
+        i++;
+    }
+    return i;
+#endif
+}
+
+mazeEditor::mazeEditor()
+{
+    _map = NULL;
+    _done = 0;
+    _depth = 0;
+}
+
+void mazeEditor::setMaze(baseMap *map)
+{
+    _map = map;
+    this->forget();
+}
+
+void mazeEditor::forget()
+{
+    _edges.clear();
+    _starts.clear();
+    _pending.clear();
+    _done = 0;
+    _depth = 0;
+}
+
+bool mazeEditor::edgeOf(int x, int y, Wall pos, uint32_t &edge) const
+{
+    int width = _map->width(), height = _map->height();
+    if(x < 0 || y < 0 || x >= width || y >= height)
+    {
+        return false;
+    }
+    if(pos == TOP && y < height-1)
+    {
+        edge = (uint32_t)(((size_t)y*width+x) << 1 | 1);
+    }
+    else if(pos == BOTTOM && y > 0)
+    {
+        edge = (uint32_t)(((size_t)(y-1)*width+x) << 1 | 1);
+    }
+    else if(pos == LEFT && x > 0)
+    {
+        edge = (uint32_t)(((size_t)y*(width-1)+x-1) << 1);
+    }
+    else if(pos == RIGHT && x < width-1)
+    {
+        edge = (uint32_t)(((size_t)y*(width-1)+x) << 1);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void mazeEditor::flip(uint32_t edge)
+{
+    uint64_t *words = edge & 1 ? _map->mutableWordsH() : _map->mutableWordsV();
+    size_t i = edge >> 1;
+    words[i >> 6] ^= (uint64_t)1 << (i & 63);
+}
+
+void mazeEditor::record(uint32_t edge)
+{
+    this->flip(edge);
+    _pending.push_back(edge);
+}
+
+void mazeEditor::flipEdit(size_t edit)
+{
+    size_t end = edit + 1 < _starts.size() ? _starts[edit + 1] : _edges.size();
+    for(size_t i = _starts[edit]; i < end; i++)
+    {
+        this->flip(_edges[i]);
+    }
+}
+
+void mazeEditor::begin()
+{
+    _depth++;
+}
+
+void mazeEditor::setWall(int x, int y, Wall pos, bool isWall)
+{
+    uint32_t edge;
+    if(!_map || !this->edgeOf(x, y, pos, edge) || _map->isWall(x, y, pos) == isWall)
+    {
+        return;
+    }
+    this->begin();
+    this->record(edge);
+    this->end();
+}
+
+//the edit only joins the history, and ends what could be redone, once it changed something
+bool mazeEditor::end()
+{
+    if(!_depth || --_depth || _pending.empty())
+    {
+        return !_pending.empty();
+    }
+    _edges.resize(_done < _starts.size() ? _starts[_done] : _edges.size());
+    _starts.resize(_done);
+    _starts.push_back(_edges.size());
+    _edges.insert(_edges.end(), _pending.begin(), _pending.end());
+    _pending.clear();
+    _done = _starts.size();
+    this->trim();
+    return true;
+}
+
+//drops the oldest edits until the rest fit, the last edit always stays
+void mazeEditor::trim()
+{
+    size_t drop = 0;
+    while(drop + 1 < _starts.size() && _edges.size() - _starts[drop] > maxEdges)
+    {
+        drop++;
+    }
+    if(!drop)
+    {
+        return;
+    }
+    size_t first = _starts[drop];
+    _edges.erase(_edges.begin(), _edges.begin() + first);
+    _starts.erase(_starts.begin(), _starts.begin() + drop);
+    for(size_t i = 0; i < _starts.size(); i++)
+    {
+        _starts[i] -= first;
+    }
+    _done -= drop;
+}
+
+bool mazeEditor::rectWalls(int x0, int y0, int x1, int y1, bool isWall)
+{
+    if(x0 > x1) std::swap(x0, x1);
+    if(y0 > y1) std::swap(y0, y1);
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, _map->width() - 1);
+    y1 = std::min(y1, _map->height() - 1);
+
+    this->begin();
+    for(int y = y0; y <= y1; y++)
+    {
+        for(int x = x0; x <= x1; x++)
+        {
+            //every inside wall belongs to two cells, the left and bottom ones of the
+            //rectangle's edge are the only ones not reached as a right or top wall
+            if(isWall || x < x1)
+            {
+                this->setWall(x, y, RIGHT, isWall);
+            }
+            if(isWall || y < y1)
+            {
+                this->setWall(x, y, TOP, isWall);
+            }
+            if(isWall && x == x0)
+            {
+                this->setWall(x, y, LEFT, true);
+            }
+            if(isWall && y == y0)
+            {
+                this->setWall(x, y, BOTTOM, true);
+            }
+        }
+    }
+    return this->end();
+}
+
+bool mazeEditor::fillRect(int x0, int y0, int x1, int y1)
+{
+    return _map && this->rectWalls(x0, y0, x1, y1, true);
+}
+
+bool mazeEditor::clearRect(int x0, int y0, int x1, int y1)
+{
+    return _map && this->rectWalls(x0, y0, x1, y1, false);
+}
+
+bool mazeEditor::transform(mazeTransform how)
+{
+    int width = _map ? _map->width() : 0, height = _map ? _map->height() : 0;
+    if(!_map || ((how == ROTATE_RIGHT || how == ROTATE_LEFT) && width != height))
+    {
+        return false;
+    }
+
+    //the right and top wall of every cell, as which wall of which cell they become
+    Wall right, top;
+    switch(how)
+    {
+    case MIRROR_LEFT_RIGHT: right = LEFT; top = TOP; break;
+    case MIRROR_TOP_BOTTOM: right = RIGHT; top = BOTTOM; break;
+    case ROTATE_RIGHT: right = BOTTOM; top = RIGHT; break;
+    case ROTATE_180: right = LEFT; top = BOTTOM; break;
+    default: right = TOP; top = LEFT; break;
+    }
+    baseMap moved(width, height);
+    moved.clear();
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int nx, ny;
+            switch(how)
+            {
+            case MIRROR_LEFT_RIGHT: nx = width-1-x; ny = y; break;
+            case MIRROR_TOP_BOTTOM: nx = x; ny = height-1-y; break;
+            case ROTATE_RIGHT: nx = y; ny = width-1-x; break;
+            case ROTATE_180: nx = width-1-x; ny = height-1-y; break;
+            default: nx = height-1-y; ny = x; break;
+            }
+            if(x < width-1 && _map->isWallRight(x, y))
+            {
+                moved.setWall(nx, ny, right, true);
+            }
+            if(y < height-1 && _map->isWallTop(x, y))
+            {
+                moved.setWall(nx, ny, top, true);
+            }
+        }
+    }
+
+    //only the words that differ are walked, a bit at a time. A mapped maze is
+    //copied out first so the words don't move under the loop
+    _map->mutableWordsV();
+    this->begin();
+    const uint64_t *words[2] = {_map->wordsV(), _map->wordsH()};
+    const uint64_t *target[2] = {moved.wordsV(), moved.wordsH()};
+    size_t count[2] = {baseMap::vWords(width, height), baseMap::hWords(width, height)};
+    size_t edges[2] = {(size_t)(width-1)*height, (size_t)width*(height-1)};
+    for(int side = 0; side < 2; side++)
+    {
+        for(size_t w = 0; w < count[side]; w++)
+        {
+            uint64_t changed = words[side][w] ^ target[side][w];
+            while(changed)
+            {
+                size_t i = w*64 + lowestBit(changed);
+                changed &= changed - 1;
+                if(i < edges[side])
+                {
+                    this->record((uint32_t)(i << 1 | side));
+                }
+            }
+        }
+    }
+    this->end();
+    return true;
+}
+
+bool mazeEditor::canUndo() const
+{
+    return _map && !_depth && _done > 0;
+}
+
+bool mazeEditor::canRedo() const
+{
+    return _map && !_depth && _done < _starts.size();
+}
+
+bool mazeEditor::undo()
+{
+    if(!this->canUndo())
+    {
+        return false;
+    }
+    this->flipEdit(--_done);
+    return true;
+}
+
+bool mazeEditor::redo()
+{
+    if(!this->canRedo())
+    {
+        return false;
+    }
+    this->flipEdit(_done++);
+    return true;
+}
+
+size_t mazeEditor::journalBytes() const
+{
+    return _edges.size()*sizeof(uint32_t) + _starts.size()*sizeof(size_t);
+}
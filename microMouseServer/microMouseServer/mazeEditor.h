@@ -0,0 +1,73 @@
+#ifndef MAZEEDITOR_H
+#define MAZEEDITOR_H
+
+#include "mazeBase.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//where every cell and its walls go, only the walls move. Quarter turns need a
+//square maze, the view has y going up so clockwise is as seen on screen
+enum mazeTransform
+{
+    MIRROR_LEFT_RIGHT,
+    MIRROR_TOP_BOTTOM,
+    ROTATE_RIGHT,
+    ROTATE_180,
+    ROTATE_LEFT
+};
+
+//Qt free wall editing with undo for the GUI's maze editor. Every edit is kept as
+//the wall bits it flipped, 4 bytes a wall, and flipping the same bits again takes
+//it back, so undo and redo are the same xor. A drag, a rectangle or a transform
+//is one edit however many walls it touches.
+class mazeEditor
+{
+public:
+    mazeEditor();
+
+    //the maze edits go to, forgets the history. Call forget() when the maze is
+    //replaced some other way (loaded, generated)
+    void setMaze(baseMap *map);
+    void forget();
+
+    //setWall() calls between begin() and end() are one edit, end() is true if
+    //any of them changed a wall. setWall() outside of them is an edit of its own
+    void begin();
+    void setWall(int x, int y, Wall pos, bool isWall);
+    bool end();
+
+    //all walls of the cells from x0,y0 to x1,y1 (any two corners, 0 based), or just
+    //the walls between two of those cells. True if anything changed
+    bool fillRect(int x0, int y0, int x1, int y1);
+    bool clearRect(int x0, int y0, int x1, int y1);
+    //false for a quarter turn of a maze that isn't square
+    bool transform(mazeTransform how);
+
+    bool canUndo() const;
+    bool canRedo() const;
+    bool undo();
+    bool redo();
+    //the history is capped, the oldest edits go first
+    size_t journalBytes() const;
+
+private:
+    //an inside wall as a bit index, vertical walls shifted left once and
+    //horizontal ones also with the low bit set. False for the outside walls
+    bool edgeOf(int x, int y, Wall pos, uint32_t &edge) const;
+    void flip(uint32_t edge);
+    //flips edge and adds it to the edit being made
+    void record(uint32_t edge);
+    void flipEdit(size_t edit);
+    bool rectWalls(int x0, int y0, int x1, int y1, bool isWall);
+    void trim();
+
+    baseMap *_map;
+    std::vector<uint32_t> _edges;   //the flipped walls of every edit, back to back
+    std::vector<size_t> _starts;    //where each edit begins in _edges
+    std::vector<uint32_t> _pending; //the edit between begin() and end()
+    size_t _done;                   //edits before this one are applied, the rest can be redone
+    int _depth;                     //begin() calls still open
+};
+
+#endif // MAZEEDITOR_H
@@ -0,0 +1,121 @@
+//mazeGen - seeded maze generator for benchmark corpora, runs on every core. Mazes
+//with a start other than 1,1 or a goal are written as .mazb even without --binary,
+//a .maz file can't store either
+//
+//usage: mazeGen [-j threads] [--count n] [--out dir] [--binary] [--algorithm backtracker|kruskal|prim]
+//               [--size WxH] [--start x,y] [--maze-goal x,y] [--braid p] [--islanded] [--seed n]
+
+#include "mazeGenerator.h"
+#include "mazeIO.h"
+#include "taskPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+//mazes per pool job, each job reuses one generator and one maze
+#define GEN_BLOCK 256
+
+static void usage()
+{
+    fprintf(stderr, "usage: mazeGen [-j threads] [--count n] [--out dir] [--binary] [--algorithm backtracker|kruskal|prim]\n"
+                    "               [--size WxH] [--start x,y] [--maze-goal x,y] [--braid p] [--islanded] [--seed n]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int threads = 0;
+    long count = 1;
+    const char *outDir = NULL;
+    bool binary = false;
+    mazeGenOptions options;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool ok;
+        if(parseGenOption(argc, argv, i, options, ok))
+        {
+            if(!ok)
+            {
+                usage();
+                return 1;
+            }
+        }
+        else if(!strcmp(argv[i], "-j") && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--count") && i + 1 < argc)
+        {
+            count = atol(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--out") && i + 1 < argc)
+        {
+            outDir = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--binary"))
+        {
+            binary = true;
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if(count < 1)
+    {
+        usage();
+        return 1;
+    }
+
+    //without --out the mazes are only made in memory, handy for timing the generator
+    if(outDir && !makeMazeDir(outDir))
+    {
+        fprintf(stderr, "can't create %s\n", outDir);
+        return 2;
+    }
+    const char *extension = genMazeExtension(options, binary);
+    if(outDir && !binary && !strcmp(extension, "mazb"))
+    {
+        fprintf(stderr, "writing .mazb files, .maz files can't store the start and goal\n");
+    }
+    std::atomic<long> failed(0);
+    taskPool pool(threads);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    pool.run((int)((count + GEN_BLOCK - 1) / GEN_BLOCK), [&](int block) {
+        mazeGenerator generator(options);
+        baseMap maze;
+        char fileName[4096];
+        long end = std::min(count, (long)(block + 1) * GEN_BLOCK);
+        for(long i = (long)block * GEN_BLOCK; i < end; i++)
+        {
+            generator.generate(i, maze);
+            if(outDir)
+            {
+                snprintf(fileName, sizeof(fileName), "%s/maze_%06ld.%s", outDir, i, extension);
+                if(writeMaze(fileName, maze) != MAZE_OK)
+                {
+                    failed++;
+                }
+            }
+        }
+    });
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if(failed < count)
+    {
+        printf("%ld %dx%d %s mazes in %.3f ms (%.0f per second) on %d threads\n", count, options.width, options.height,
+               mazeAlgorithmName(options.algorithm), ms, count / (ms / 1000), pool.threadCount());
+    }
+    if(failed)
+    {
+        fprintf(stderr, "%s\n%ld mazes could not be written\n", mazeErrorString(MAZE_ERR_OPEN), (long)failed);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Maze generator for benchmark corpora, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console thread
+CONFIG   -= app_bundle qt
+
+TARGET = mazeGen
+TEMPLATE = app
+
+include(simCore.pri)
+
+SOURCES += mazeGen.cpp \
+    taskPool.cpp
+
+HEADERS += taskPool.h
@@ -0,0 +1,110 @@
+//mazeGenTest - generates mazes with different start and goal options, writes them
+//the way mazeGen does and reads them back. Exits with 1 if any maze doesn't come
+//back with the same walls, start and goal
+//
+//usage: mazeGenTest [--tmp dir]
+
+#include "mazeGenerator.h"
+#include "mazeIO.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+//the same options as on mazeGen's command line, as one string
+static bool parseOptions(const char *args, mazeGenOptions &options)
+{
+    char buffer[256];
+    char *argv[16];
+    int argc = 1;
+    argv[0] = (char *)"mazeGen";
+    snprintf(buffer, sizeof(buffer), "%s", args);
+    for(char *word = strtok(buffer, " "); word && argc < 16; word = strtok(NULL, " "))
+    {
+        argv[argc++] = word;
+    }
+    for(int i = 1; i < argc; i++)
+    {
+        bool ok;
+        if(!parseGenOption(argc, argv, i, options, ok) || !ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool roundTrip(const char *args, bool binary, const std::string &tmp)
+{
+    mazeGenOptions options;
+    if(!parseOptions(args, options))
+    {
+        printf("FAIL %-50s bad options\n", args);
+        return false;
+    }
+    const char *extension = genMazeExtension(options, binary);
+    std::string fileName = tmp + "/mazeGenTest." + extension;
+    mazeGenerator generator(options);
+    baseMap made, loaded;
+    mazeError err = MAZE_OK;
+    bool ok = true;
+    for(int i = 0; ok && i < 4; i++)
+    {
+        generator.generate(i, made);
+        err = writeMaze(fileName.c_str(), made);
+        if(err == MAZE_OK)
+        {
+            err = readMaze(fileName.c_str(), loaded);
+        }
+        ok = err == MAZE_OK && loaded.width() == made.width() && loaded.height() == made.height() &&
+             loaded.startX() == made.startX() && loaded.startY() == made.startY() &&
+             loaded.hasGoal() == made.hasGoal() && loaded.goalX() == made.goalX() && loaded.goalY() == made.goalY() &&
+             mazeChecksum(loaded) == mazeChecksum(made);
+    }
+    remove(fileName.c_str());
+
+    char goal[32] = "none";
+    if(made.hasGoal())
+    {
+        snprintf(goal, sizeof(goal), "%d,%d", made.goalX() + 1, made.goalY() + 1);
+    }
+    printf("%s %-50s .%-4s start %d,%d goal %s%s%s\n", ok ? "ok  " : "FAIL", args, extension, made.startX() + 1,
+           made.startY() + 1, goal, err != MAZE_OK ? ", " : "", err != MAZE_OK ? mazeErrorString(err) : "");
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string tmp = "/tmp";
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--tmp") && i + 1 < argc)
+        {
+            tmp = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: mazeGenTest [--tmp dir]\n");
+            return 1;
+        }
+    }
+
+    //the goal room, a given start and goal, and a maze too small for a room,
+    //the only kind that still goes out as text
+    const char *cases[] = {
+        "",
+        "--islanded --braid 0.5",
+        "--size 24x16",
+        "--start 8,8 --maze-goal 1,1",
+        "--start 3,1",
+        "--size 33x9 --algorithm kruskal --maze-goal 12,8",
+        "--size 3x3 --algorithm prim"
+    };
+    int failed = 0;
+    for(size_t c = 0; c < sizeof(cases)/sizeof(cases[0]); c++)
+    {
+        failed += !roundTrip(cases[c], false, tmp);
+        failed += !roundTrip(cases[c], true, tmp);
+    }
+    printf("%d failed\n", failed);
+    return failed ? 1 : 0;
+}
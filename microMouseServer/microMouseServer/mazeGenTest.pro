@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Generated maze round trip test, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console thread
+CONFIG   -= app_bundle qt
+
+TARGET = mazeGenTest
+TEMPLATE = app
+
+include(simCore.pri)
+
+SOURCES += mazeGenTest.cpp
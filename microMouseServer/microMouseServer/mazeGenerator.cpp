@@ -0,0 +1,534 @@
+#include "mazeGenerator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//mDirection order, right turn is +1
+static const int genDX[4] = {1, 0, -1, 0};
+static const int genDY[4] = {0, -1, 0, 1};
+
+mazeGenOptions::mazeGenOptions()
+{
+    algorithm = GEN_BACKTRACKER;
+    width = DEFAULT_MAZE_WIDTH;
+    height = DEFAULT_MAZE_HEIGHT;
+    startX = 0;
+    startY = 0;
+    goalX = -1;
+    goalY = -1;
+    braid = 0;
+    islanded = false;
+    seed = 1;
+}
+
+mazeGenerator::mazeGenerator(const mazeGenOptions &options)
+{
+    _options = options;
+    _v = NULL;
+    _h = NULL;
+}
+
+int mazeGenerator::neighbour(int cell, int dir) const
+{
+    int x = cell % _options.width + genDX[dir];
+    int y = cell / _options.width + genDY[dir];
+    if(x < 0 || y < 0 || x >= _options.width || y >= _options.height)
+    {
+        return -1;
+    }
+    return y*_options.width + x;
+}
+
+//the bit for a wall is always found from the cell left of or below it
+static inline void wallBit(int cell, int dir, int width, bool &vertical, size_t &bit)
+{
+    int x = cell % width, y = cell / width;
+    vertical = dir == dRIGHT || dir == dLEFT;
+    if(dir == dLEFT) x--;
+    if(dir == dDOWN) y--;
+    bit = vertical ? (size_t)y*(width-1) + x : (size_t)y*width + x;
+}
+
+bool mazeGenerator::isOpen(int cell, int dir) const
+{
+    if(neighbour(cell, dir) < 0)
+    {
+        return false;
+    }
+    bool vertical;
+    size_t bit;
+    wallBit(cell, dir, _options.width, vertical, bit);
+    const uint64_t *words = vertical ? _v : _h;
+    return !((words[bit >> 6] >> (bit & 63)) & 1);
+}
+
+void mazeGenerator::carve(int cell, int dir)
+{
+    bool vertical;
+    size_t bit;
+    wallBit(cell, dir, _options.width, vertical, bit);
+    uint64_t *words = vertical ? _v : _h;
+    words[bit >> 6] &= ~((uint64_t)1 << (bit & 63));
+}
+
+void mazeGenerator::build(int cell, int dir)
+{
+    bool vertical;
+    size_t bit;
+    wallBit(cell, dir, _options.width, vertical, bit);
+    uint64_t *words = vertical ? _v : _h;
+    words[bit >> 6] |= (uint64_t)1 << (bit & 63);
+}
+
+//sets the first count bits and leaves the padding after them 0 like baseMap expects
+static void fillWalls(uint64_t *words, size_t count)
+{
+    size_t full = count / 64;
+    std::fill(words, words + full, ~(uint64_t)0);
+    words[full] = count % 64 ? ((uint64_t)1 << (count % 64)) - 1 : 0;
+}
+
+//no goal given, the maze gets a contest style room in the middle if it is big enough
+static bool hasGoalRoom(const mazeGenOptions &options)
+{
+    return options.goalX < 0 && options.width >= 4 && options.height >= 4;
+}
+
+void mazeGenerator::generate(uint64_t index, baseMap &data)
+{
+    int width = _options.width, height = _options.height;
+    if(data.width() != width || data.height() != height)
+    {
+        data.resize(width, height);
+    }
+    data.setStart(_options.startX, _options.startY);
+    _v = data.mutableWordsV();
+    _h = data.mutableWordsH();
+    fillWalls(_v, (size_t)(width-1)*height);
+    fillWalls(_h, (size_t)width*(height-1));
+
+    //every maze of a corpus gets its own stream, independent of the order they are made in
+    mazeRandom random(mazeRandom(_options.seed).next() ^ (index * 0xd1342543de82ef95ull));
+    size_t cells = (size_t)width*height;
+    _visited.assign(cells/64 + 1, 0);
+
+    //without a goal the maze gets a contest style room in the middle, cut into the finished tree
+    bool room = hasGoalRoom(_options);
+    if(room)
+    {
+        data.setGoal(width/2 - 1, height/2 - 1);
+    }
+    else
+    {
+        data.setGoal(_options.goalX, _options.goalY);
+    }
+
+    switch(_options.algorithm)
+    {
+    case GEN_BACKTRACKER:
+        this->backtracker(random);
+        break;
+    case GEN_KRUSKAL:
+        this->kruskal(random);
+        break;
+    case GEN_PRIM:
+        this->prim(random);
+        break;
+    }
+    if(room)
+    {
+        this->goalRoom(random);
+    }
+    if(_options.braid > 0)
+    {
+        this->braid(random);
+    }
+}
+
+//depth first with an explicit stack, long winding corridors
+void mazeGenerator::backtracker(mazeRandom &random)
+{
+    int start = _options.startY*_options.width + _options.startX;
+    _stack.clear();
+    _stack.push_back(start);
+    this->visit(start);
+    while(!_stack.empty())
+    {
+        int cell = _stack.back();
+        int options[4], count = 0;
+        for(int dir = 0; dir < 4; dir++)
+        {
+            int next = this->neighbour(cell, dir);
+            if(next >= 0 && !this->isVisited(next))
+            {
+                options[count++] = dir;
+            }
+        }
+        if(!count)
+        {
+            _stack.pop_back();
+            continue;
+        }
+        int dir = options[random.below(count)];
+        int next = this->neighbour(cell, dir);
+        this->carve(cell, dir);
+        this->visit(next);
+        _stack.push_back(next);
+    }
+}
+
+static int findRoot(std::vector<int> &parent, int cell)
+{
+    while(parent[cell] != cell)
+    {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+//random spanning tree over all walls, lots of short dead ends
+void mazeGenerator::kruskal(mazeRandom &random)
+{
+    int width = _options.width, height = _options.height;
+    int cells = width*height;
+    _parent.resize(cells);
+    for(int i = 0; i < cells; i++)
+    {
+        _parent[i] = i;
+    }
+
+    //wall ids are cell*2 for the wall right of it and cell*2+1 for the one above it
+    _edges.clear();
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int cell = y*width + x;
+            if(x < width-1) _edges.push_back(cell*2);
+            if(y < height-1) _edges.push_back(cell*2 + 1);
+        }
+    }
+    for(size_t i = _edges.size(); i > 1; i--)
+    {
+        std::swap(_edges[i-1], _edges[random.below(i)]);
+    }
+
+    int joined = 1;
+    for(size_t i = 0; i < _edges.size() && joined < cells; i++)
+    {
+        int cell = _edges[i] >> 1;
+        int dir = _edges[i] & 1 ? dUP : dRIGHT;
+        int a = findRoot(_parent, cell), b = findRoot(_parent, this->neighbour(cell, dir));
+        if(a != b)
+        {
+            _parent[a] = b;
+            this->carve(cell, dir);
+            joined++;
+        }
+    }
+}
+
+//grows out from the start picking a random wall on the edge of the maze each time
+void mazeGenerator::prim(mazeRandom &random)
+{
+    int start = _options.startY*_options.width + _options.startX;
+    //frontier ids are cell*4+dir, a wall from a visited cell
+    _edges.clear();
+    this->visit(start);
+    for(int dir = 0; dir < 4; dir++)
+    {
+        if(this->neighbour(start, dir) >= 0) _edges.push_back(start*4 + dir);
+    }
+    while(!_edges.empty())
+    {
+        size_t pick = random.below(_edges.size());
+        uint32_t edge = _edges[pick];
+        _edges[pick] = _edges.back();
+        _edges.pop_back();
+
+        int cell = edge >> 2, dir = edge & 3;
+        int next = this->neighbour(cell, dir);
+        if(this->isVisited(next))
+        {
+            continue;
+        }
+        this->carve(cell, dir);
+        this->visit(next);
+        for(int d = 0; d < 4; d++)
+        {
+            int after = this->neighbour(next, d);
+            if(after >= 0 && !this->isVisited(after)) _edges.push_back(next*4 + d);
+        }
+    }
+}
+
+static inline bool isRoomCell(int x, int y, int rx, int ry)
+{
+    return x >= rx && x <= rx + 1 && y >= ry && y <= ry + 1;
+}
+
+//2x2 room around the goal with its inside open. The ways into it the tree used are
+//closed but one, the parts of the maze that cuts off are joined back on one wall at a time
+//so apart from the room itself the maze stays a tree
+void mazeGenerator::goalRoom(mazeRandom &random)
+{
+    int width = _options.width;
+    int rx = width/2 - 1, ry = _options.height/2 - 1;
+    int room[4] = {ry*width + rx, ry*width + rx + 1, (ry+1)*width + rx, (ry+1)*width + rx + 1};
+
+    int doors[8], doorCount = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        for(int dir = 0; dir < 4; dir++)
+        {
+            int next = this->neighbour(room[i], dir);
+            bool inside = next == room[0] || next == room[1] || next == room[2] || next == room[3];
+            if(next < 0)
+            {
+                continue;
+            }
+            if(inside)
+            {
+                this->carve(room[i], dir);
+            }
+            else
+            {
+                if(this->isOpen(room[i], dir))
+                {
+                    doors[doorCount++] = room[i]*4 + dir;
+                }
+                this->build(room[i], dir);
+            }
+        }
+    }
+
+    //the room is now sealed, flood the rest from the start and open walls from
+    //reached cells into unreached ones until everything is one tree again
+    int cells = width*_options.height;
+    _visited.assign(cells/64 + 1, 0);
+    int opened = doorCount ? doors[random.below(doorCount)] : room[0]*4 + dLEFT;
+    this->carve(opened >> 2, opened & 3);
+    int doorsLeft = _options.islanded ? 1 : 0;
+
+    _stack.clear();
+    int start = _options.startY*width + _options.startX;
+    _stack.push_back(start);
+    this->visit(start);
+    for(;;)
+    {
+        while(!_stack.empty())
+        {
+            int cell = _stack.back();
+            _stack.pop_back();
+            for(int dir = 0; dir < 4; dir++)
+            {
+                int next = this->neighbour(cell, dir);
+                if(next >= 0 && !this->isVisited(next) && this->isOpen(cell, dir))
+                {
+                    this->visit(next);
+                    _stack.push_back(next);
+                }
+            }
+        }
+
+        //first unreached cell next to a reached one gets joined on
+        int join = -1, joinDir = 0;
+        for(int cell = 0; cell < cells && join < 0; cell++)
+        {
+            if(!this->isVisited(cell))
+            {
+                continue;
+            }
+            for(int dir = 0; dir < 4; dir++)
+            {
+                int next = this->neighbour(cell, dir);
+                if(next >= 0 && !this->isVisited(next))
+                {
+                    join = cell;
+                    joinDir = dir;
+                    break;
+                }
+            }
+        }
+        if(join < 0)
+        {
+            break;
+        }
+        this->carve(join, joinDir);
+        int next = this->neighbour(join, joinDir);
+        this->visit(next);
+        _stack.push_back(next);
+    }
+
+    if(!_options.islanded || rx < 1 || ry < 1 || rx + 2 >= width || ry + 2 >= _options.height)
+    {
+        return;
+    }
+
+    //islanded: clear every wall between the cells around the room so the room
+    //walls don't touch anything that leads to the outside, then add a second door
+    for(int y = ry - 1; y <= ry + 2; y++)
+    {
+        for(int x = rx - 1; x <= rx + 2; x++)
+        {
+            if(x < rx + 2 && !isRoomCell(x, y, rx, ry) && !isRoomCell(x + 1, y, rx, ry))
+            {
+                this->carve(y*width + x, dRIGHT);
+            }
+            if(y < ry + 2 && !isRoomCell(x, y, rx, ry) && !isRoomCell(x, y + 1, rx, ry))
+            {
+                this->carve(y*width + x, dUP);
+            }
+        }
+    }
+    while(doorsLeft)
+    {
+        int side = room[random.below(4)];
+        int dir = random.below(4);
+        int next = this->neighbour(side, dir);
+        if(next != room[0] && next != room[1] && next != room[2] && next != room[3] && !this->isOpen(side, dir))
+        {
+            this->carve(side, dir);
+            doorsLeft--;
+        }
+    }
+}
+
+//knocks a wall out of dead ends, preferring one that ends another dead end too
+void mazeGenerator::braid(mazeRandom &random)
+{
+    int width = _options.width, height = _options.height;
+    int goal = _options.goalX < 0 ? -1 : _options.goalY*width + _options.goalX;
+    int rx = width/2 - 1, ry = height/2 - 1;
+    bool room = hasGoalRoom(_options);
+    for(int cell = 0; cell < width*height; cell++)
+    {
+        int x = cell % width, y = cell / width;
+        if(cell == goal || (room && isRoomCell(x, y, rx, ry)))
+        {
+            continue;
+        }
+        int open = 0, closed[4], closedCount = 0;
+        for(int dir = 0; dir < 4; dir++)
+        {
+            if(this->isOpen(cell, dir))
+            {
+                open++;
+            }
+            else
+            {
+                int next = this->neighbour(cell, dir);
+                if(next >= 0 && !(room && isRoomCell(next % width, next / width, rx, ry)))
+                {
+                    closed[closedCount++] = dir;
+                }
+            }
+        }
+        if(open != 1 || !closedCount || random.unit() >= _options.braid)
+        {
+            continue;
+        }
+
+        int dir = closed[random.below(closedCount)];
+        for(int i = 0; i < closedCount; i++)
+        {
+            int next = this->neighbour(cell, closed[i]), nextOpen = 0;
+            for(int d = 0; d < 4; d++)
+            {
+                nextOpen += this->isOpen(next, d);
+            }
+            if(nextOpen == 1)
+            {
+                dir = closed[i];
+                break;
+            }
+        }
+        this->carve(cell, dir);
+    }
+}
+
+const char *mazeAlgorithmName(mazeAlgorithm algorithm)
+{
+    switch(algorithm)
+    {
+    case GEN_BACKTRACKER:
+        return "backtracker";
+    case GEN_KRUSKAL:
+        return "kruskal";
+    case GEN_PRIM:
+        return "prim";
+    }
+    return "unknown";
+}
+
+const char *genMazeExtension(const mazeGenOptions &options, bool binary)
+{
+    bool text = !binary && options.startX == 0 && options.startY == 0 && options.goalX < 0 && !hasGoalRoom(options);
+    return text ? "maz" : "mazb";
+}
+
+bool parseGenOption(int argc, char *argv[], int &i, mazeGenOptions &options, bool &ok)
+{
+    ok = true;
+    if(!strcmp(argv[i], "--islanded"))
+    {
+        options.islanded = true;
+        return true;
+    }
+    if(i + 1 >= argc)
+    {
+        return false;
+    }
+
+    const char *value = argv[i + 1];
+    if(!strcmp(argv[i], "--algorithm"))
+    {
+        ok = false;
+        for(int a = GEN_BACKTRACKER; a <= GEN_PRIM; a++)
+        {
+            if(!strcmp(value, mazeAlgorithmName(mazeAlgorithm(a))))
+            {
+                options.algorithm = mazeAlgorithm(a);
+                ok = true;
+            }
+        }
+    }
+    else if(!strcmp(argv[i], "--size"))
+    {
+        ok = sscanf(value, "%dx%d", &options.width, &options.height) == 2 && options.width >= 1 &&
+             options.height >= 1 && options.width <= MAZE_MAX_SIZE && options.height <= MAZE_MAX_SIZE;
+    }
+    else if(!strcmp(argv[i], "--start"))
+    {
+        ok = sscanf(value, "%d,%d", &options.startX, &options.startY) == 2;
+        options.startX--;
+        options.startY--;
+    }
+    else if(!strcmp(argv[i], "--maze-goal"))
+    {
+        ok = sscanf(value, "%d,%d", &options.goalX, &options.goalY) == 2;
+        options.goalX--;
+        options.goalY--;
+    }
+    else if(!strcmp(argv[i], "--braid"))
+    {
+        options.braid = atof(value);
+        ok = options.braid >= 0 && options.braid <= 1;
+    }
+    else if(!strcmp(argv[i], "--seed"))
+    {
+        options.seed = strtoull(value, NULL, 10);
+    }
+    else
+    {
+        return false;
+    }
+    i++;
+
+    ok = ok && options.startX >= 0 && options.startY >= 0 && options.startX < options.width &&
+         options.startY < options.height && options.goalX < options.width && options.goalY < options.height &&
+         (options.goalX < 0) == (options.goalY < 0);
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef MAZEGENERATOR_H
+#define MAZEGENERATOR_H
+
+#include "mazeBase.h"
+#include <stdint.h>
+#include <vector>
+
+enum mazeAlgorithm
+{
+    GEN_BACKTRACKER,
+    GEN_KRUSKAL,
+    GEN_PRIM
+};
+
+//everything that decides what a generated maze looks like. Start and goal are
+//0 based, a goal of -1,-1 puts a 2x2 goal room in the middle like a real contest maze
+struct mazeGenOptions
+{
+    mazeGenOptions();
+
+    mazeAlgorithm algorithm;
+    int width, height;
+    int startX, startY;
+    int goalX, goalY;
+    //chance of knocking a loop into each dead end, 0 is a perfect maze and 1 has no dead ends
+    double braid;
+    //opens the goal room from more than one side and cuts it loose from the outer
+    //walls so following a wall can't find it
+    bool islanded;
+    uint64_t seed;
+};
+
+//small fast generator with a fixed algorithm so a seed is the same maze everywhere
+class mazeRandom
+{
+public:
+    explicit mazeRandom(uint64_t seed) : _state(seed) {}
+
+    //splitmix64
+    uint64_t next()
+    {
+        uint64_t z = (_state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    //0 to n-1
+    uint32_t below(uint32_t n) { return (uint32_t)(((next() >> 32) * n) >> 32); }
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+    uint64_t _state;
+};
+
+//Seeded maze generator, writes straight into the baseMap wall words. The same
+//options and index always give the same maze whatever thread makes it, so a
+//corpus can be described by its options alone. Scratch memory is kept between
+//calls, use one generator per thread.
+class mazeGenerator
+{
+public:
+    explicit mazeGenerator(const mazeGenOptions &options);
+
+    //maze number index of the corpus
+    void generate(uint64_t index, baseMap &data);
+
+private:
+    void backtracker(mazeRandom &random);
+    void kruskal(mazeRandom &random);
+    void prim(mazeRandom &random);
+    void braid(mazeRandom &random);
+    void goalRoom(mazeRandom &random);
+
+    //cells are y*width+x, dir uses mDirection
+    int neighbour(int cell, int dir) const;
+    bool isOpen(int cell, int dir) const;
+    void carve(int cell, int dir);
+    void build(int cell, int dir);
+    bool isVisited(int cell) const { return (_visited[cell >> 6] >> (cell & 63)) & 1; }
+    void visit(int cell) { _visited[cell >> 6] |= (uint64_t)1 << (cell & 63); }
+
+    mazeGenOptions _options;
+    uint64_t *_v, *_h;
+    std::vector<uint64_t> _visited;
+    std::vector<int> _stack;
+    std::vector<int> _parent;
+    std::vector<uint32_t> _edges;
+};
+
+//reads one generator option at argv[i] for the command line tools, moves i past
+//its value. Returns false if argv[i] isn't a generator option
+bool parseGenOption(int argc, char *argv[], int &i, mazeGenOptions &options, bool &ok);
+//extension for writing generated mazes, "maz" only when binary isn't asked for and
+//the mazes have no goal and start at 1,1. A .maz file stores neither, "mazb" otherwise
+const char *genMazeExtension(const mazeGenOptions &options, bool binary);
+const char *mazeAlgorithmName(mazeAlgorithm algorithm);
+
+#endif // MAZEGENERATOR_H
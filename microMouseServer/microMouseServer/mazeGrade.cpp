@@ -0,0 +1,297 @@
+//mazeGrade - tournament grader, runs every solver on every maze on every core and
+//ranks them. Each maze gets an exploration run and a fast run, the score is the
+//fast run plus a share of the exploration run in estimated robot seconds, with
+//penalties for breaking the one moveForward per studentAI() call rule.
+//
+//usage: mazeGrade [-j threads] [--max-ticks n] [--goal x,y] [--solver name]... [--plugin file.so]... [--extra-move s]
+//                 [--blocked s] [--unsolved s] [--explore-weight w] [--detail] [--csv file] <dir|file|glob>...
+//
+//Without --solver or --plugin every solver in solverRegistry() takes part. Mazes
+//without a goal are graded against 12,8 like mazeAnalyze, or skipped if too small.
+//       mazeGrade [options] --generate n [mazeGen options]
+
+#include "mazeGrader.h"
+#include "mazeSolver.h"
+#include "solverPlugin.h"
+#include "mazeIO.h"
+#include "mazeGenerator.h"
+#include "taskPool.h"
+#include "nullBuffer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct gradeJob
+{
+    mazeError error;
+    gradeResult result;
+};
+
+static void usage()
+{
+    fprintf(stderr, "usage: mazeGrade [-j threads] [--max-ticks n] [--goal x,y] [--solver name]... [--plugin file.so]... [--extra-move s]\n"
+                    "                 [--blocked s] [--unsolved s] [--explore-weight w] [--detail] [--csv file] <dir|file|glob>...\n"
+                    "       mazeGrade [options] --generate n [--algorithm a] [--size WxH] [--start x,y] [--maze-goal x,y]\n"
+                    "                 [--braid p] [--islanded] [--seed n]\n");
+}
+
+static bool writeCsv(const char *fileName, const std::vector<solverEntry> &solvers, const std::vector<std::string> &files,
+                     const std::vector<gradeJob> &jobs)
+{
+    FILE *file = fopen(fileName, "w");
+    if(!file)
+    {
+        return false;
+    }
+    fprintf(file, "solver,maze,explore_solved,explore_ticks,explore_robot_ms,explore_extra_moves,explore_blocked,explore_score,"
+                  "fast_solved,fast_ticks,fast_robot_ms,fast_extra_moves,fast_blocked,fast_score,total\n");
+    for(size_t i = 0; i < jobs.size(); i++)
+    {
+        const gradeJob &j = jobs[i];
+        if(j.error != MAZE_OK)
+        {
+            continue;
+        }
+        const gradeRun &e = j.result.explore, &f = j.result.fast;
+        fprintf(file, "%s,%s,%d,%ld,%ld,%ld,%ld,%.3f,%d,%ld,%ld,%ld,%ld,%.3f,%.3f\n", solvers[i / files.size()].name.c_str(),
+                files[i % files.size()].c_str(), e.solved, e.stats.aiCalls, e.stats.runTime, e.stats.extraMoves, e.stats.blocked,
+                e.score, f.solved, f.stats.aiCalls, f.stats.runTime, f.stats.extraMoves, f.stats.blocked, f.score, j.result.total);
+    }
+    return fclose(file) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int threads = 0;
+    long maxTicks = 1000000;
+    int goalX = 0, goalY = 0;
+    bool goalGiven = false;
+    bool detail = false;
+    const char *csvFile = NULL;
+    gradePenalties penalties;
+    long generate = 0;
+    mazeGenOptions genOptions;
+    std::vector<std::string> files;
+    //a plugin's entry keeps its library open, the solverPlugin itself can go
+    std::vector<solverEntry> solvers;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool ok;
+        if(parseGenOption(argc, argv, i, genOptions, ok))
+        {
+            if(!ok)
+            {
+                usage();
+                return 1;
+            }
+        }
+        else if(!strcmp(argv[i], "--generate") && i + 1 < argc)
+        {
+            generate = atol(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "-j") && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--max-ticks") && i + 1 < argc)
+        {
+            maxTicks = atol(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--goal") && i + 1 < argc)
+        {
+            if(!parseMazeCell(argv[++i], goalX, goalY))
+            {
+                usage();
+                return 1;
+            }
+            goalGiven = true;
+        }
+        else if(!strcmp(argv[i], "--solver") && i + 1 < argc)
+        {
+            const solverEntry *solver = findSolver(argv[++i]);
+            if(!solver)
+            {
+                fprintf(stderr, "no solver called %s\n", argv[i]);
+                return 1;
+            }
+            solvers.push_back(*solver);
+        }
+        else if(!strcmp(argv[i], "--plugin") && i + 1 < argc)
+        {
+            solverPlugin plugin;
+            mazeError err = plugin.load(argv[++i]);
+            if(err != MAZE_OK)
+            {
+                fprintf(stderr, "%s: %s %s\n", argv[i], mazeErrorString(err), plugin.error().c_str());
+                return 1;
+            }
+            //two builds of one plugin share a name, the later one goes by its file name
+            solverEntry entry = plugin.entry();
+            for(size_t s = 0; s < solvers.size(); s++)
+            {
+                if(solvers[s].name == entry.name)
+                {
+                    entry.name = argv[i];
+                }
+            }
+            solvers.push_back(entry);
+        }
+        else if(!strcmp(argv[i], "--extra-move") && i + 1 < argc)
+        {
+            penalties.extraMove = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--blocked") && i + 1 < argc)
+        {
+            penalties.blocked = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--unsolved") && i + 1 < argc)
+        {
+            penalties.unsolved = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--explore-weight") && i + 1 < argc)
+        {
+            penalties.exploreWeight = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--detail"))
+        {
+            detail = true;
+        }
+        else if(!strcmp(argv[i], "--csv") && i + 1 < argc)
+        {
+            csvFile = argv[++i];
+        }
+        else if(argv[i][0] == '-')
+        {
+            usage();
+            return 1;
+        }
+        else if(!findMazeFiles(argv[i], files))
+        {
+            fprintf(stderr, "no maze files match %s\n", argv[i]);
+        }
+    }
+    for(long i = 0; i < generate; i++)
+    {
+        files.push_back("gen:" + std::to_string(i));
+    }
+    if(files.empty())
+    {
+        usage();
+        return 1;
+    }
+    if(solvers.empty())
+    {
+        for(size_t s = 0; s < solverRegistry().size(); s++)
+        {
+            solvers.push_back(solverRegistry()[s]);
+        }
+    }
+
+    nullBuffer discard;
+    std::streambuf *coutBuffer = std::cout.rdbuf(&discard);
+
+    //job i is solver i / mazes on maze i % mazes, every pair is independent
+    size_t mazes = files.size();
+    std::vector<gradeJob> jobs(mazes * solvers.size());
+    taskPool pool(threads);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    pool.run((int)jobs.size(), [&](int i) {
+        gradeJob &job = jobs[i];
+        size_t m = i % mazes;
+        mazeSim sim;
+        std::unique_ptr<mazeSolver> solver(solvers[i / mazes].create());
+        sim.setSolver(solver.get());
+        if(m >= mazes - generate)
+        {
+            static thread_local mazeGenerator generator(genOptions);
+            generator.generate(m - (mazes - generate), sim.mazeData);
+            job.error = MAZE_OK;
+        }
+        else
+        {
+            job.error = readMaze(files[m].c_str(), sim.mazeData);
+        }
+        if(job.error != MAZE_OK)
+        {
+            return;
+        }
+        //1 based, a maze it doesn't fit in can't be run against it
+        if(goalGiven)
+        {
+            if(goalX > sim.mazeData.width() || goalY > sim.mazeData.height())
+            {
+                job.error = MAZE_ERR_GOAL_OUTSIDE;
+                return;
+            }
+            sim.setGoal(goalX, goalY);
+        }
+        //a run is only solved on the goal, a maze without one can't be graded
+        if(!useDefaultGoal(sim.mazeData))
+        {
+            job.error = MAZE_ERR_NO_GOAL;
+            return;
+        }
+        gradeMaze(sim, penalties, maxTicks, job.result);
+    });
+
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout.rdbuf(coutBuffer);
+
+    std::vector<gradeStanding> standings(solvers.size());
+    for(size_t s = 0; s < solvers.size(); s++)
+    {
+        standings[s].solver = solvers[s].name;
+    }
+    if(detail)
+    {
+        printf("%-16s %-32s %9s %10s %11s %9s %10s %11s %10s\n", "solver", "maze", "explore", "explore s",
+               "extra moves", "fast", "fast s", "extra moves", "total");
+    }
+    for(size_t i = 0; i < jobs.size(); i++)
+    {
+        const gradeJob &j = jobs[i];
+        if(j.error != MAZE_OK)
+        {
+            if(i < mazes)
+            {
+                printf("%-32s %s\n", files[i].c_str(), mazeErrorString(j.error));
+            }
+            continue;
+        }
+        standings[i / mazes].add(j.result);
+        if(detail)
+        {
+            const gradeRun &e = j.result.explore, &f = j.result.fast;
+            printf("%-16s %-32s %9s %10.1f %11ld %9s %10.1f %11ld %10.1f\n", solvers[i / mazes].name.c_str(), files[i % mazes].c_str(),
+                   e.solved ? "yes" : "no", e.score, e.stats.extraMoves, f.solved ? "yes" : "no", f.score,
+                   f.stats.extraMoves, j.result.total);
+        }
+    }
+    if(detail)
+    {
+        printf("\n");
+    }
+
+    rankStandings(standings);
+    printf("%4s %-16s %6s %9s %9s %12s %10s %11s %11s %12s\n", "rank", "solver", "mazes", "explored", "fast runs",
+           "explore s", "fast s", "penalty s", "extra moves", "score");
+    for(size_t s = 0; s < standings.size(); s++)
+    {
+        const gradeStanding &g = standings[s];
+        printf("%4d %-16s %6d %9d %9d %12.1f %10.1f %11.1f %11ld %12.1f\n", (int)s + 1, g.solver.c_str(), g.mazes,
+               g.explored, g.fastSolved, g.exploreScore, g.fastScore, g.penalty, g.extraMoves, g.total);
+    }
+    if(csvFile && !writeCsv(csvFile, solvers, files, jobs))
+    {
+        fprintf(stderr, "can't write %s\n", csvFile);
+    }
+    printf("%d runs graded in %.3f ms on %d threads\n", (int)jobs.size(), totalMs, pool.threadCount());
+    return 0;
+}
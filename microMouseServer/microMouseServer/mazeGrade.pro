@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Tournament grader for solvers, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console thread
+CONFIG   -= app_bundle qt
+
+TARGET = mazeGrade
+TEMPLATE = app
+
+include(simCore.pri)
+
+SOURCES += mazeGrade.cpp \
+    taskPool.cpp
+
+HEADERS += taskPool.h
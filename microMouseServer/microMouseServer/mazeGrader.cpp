@@ -0,0 +1,68 @@
+#include "mazeGrader.h"
+#include <algorithm>
+
+gradePenalties::gradePenalties()
+{
+    extraMove = 2;
+    blocked = 1;
+    unsolved = 600;
+    exploreWeight = 1.0 / 30;
+}
+
+static void scoreRun(mazeSim &sim, const gradePenalties &penalties, long maxTicks, gradeRun &run)
+{
+    sim.resetMouse();
+    sim.run(maxTicks);
+    run.stats = sim.stats();
+    run.solved = sim.isSolved();
+    //an unsolved run can't score worse than unsolved, whatever it broke on the way
+    run.penalty = 0;
+    run.score = penalties.unsolved;
+    if(run.solved)
+    {
+        run.penalty = run.stats.extraMoves * penalties.extraMove + run.stats.blocked * penalties.blocked;
+        run.score = run.stats.runTime / 1000.0 + run.penalty;
+    }
+}
+
+void gradeMaze(mazeSim &sim, const gradePenalties &penalties, long maxTicks, gradeResult &result)
+{
+    sim.mazeChanged();
+    scoreRun(sim, penalties, maxTicks, result.explore);
+    //a solver that didn't find the goal has nothing to run fast
+    if(result.explore.solved)
+    {
+        scoreRun(sim, penalties, maxTicks, result.fast);
+    }
+    else
+    {
+        result.fast.stats.clear();
+        result.fast.solved = false;
+        result.fast.penalty = 0;
+        result.fast.score = penalties.unsolved;
+    }
+    result.total = result.fast.score + penalties.exploreWeight * result.explore.score;
+}
+
+void gradeStanding::add(const gradeResult &result)
+{
+    mazes++;
+    explored += result.explore.solved;
+    fastSolved += result.fast.solved;
+    exploreScore += result.explore.score;
+    fastScore += result.fast.score;
+    penalty += result.explore.penalty + result.fast.penalty;
+    total += result.total;
+    extraMoves += result.explore.stats.extraMoves + result.fast.stats.extraMoves;
+}
+
+void rankStandings(std::vector<gradeStanding> &standings)
+{
+    std::stable_sort(standings.begin(), standings.end(), [](const gradeStanding &a, const gradeStanding &b) {
+        if(a.fastSolved != b.fastSolved)
+        {
+            return a.fastSolved > b.fastSolved;
+        }
+        return a.total < b.total;
+    });
+}
@@ -0,0 +1,61 @@
+#ifndef MAZEGRADER_H
+#define MAZEGRADER_H
+
+#include "mazeSim.h"
+#include "runStats.h"
+#include <string>
+#include <vector>
+
+//turns a run into a score in seconds, lower is better. A run scores its estimated
+//robot time (see motionCost) plus its penalties
+struct gradePenalties
+{
+    gradePenalties();
+
+    double extraMove;       //per moveForward past the first in one studentAI() call
+    double blocked;         //per moveForward into a wall
+    double unsolved;        //the whole score of a run that never reached the goal
+    double exploreWeight;   //how much of the exploration run goes into the total, contests use 1/30
+};
+
+struct gradeRun
+{
+    runStats stats;
+    bool solved;
+    double penalty;
+    double score;
+};
+
+//one solver on one maze: the exploration run from a fresh start, then the fast
+//run with whatever the solver remembered, like pressing Start Run twice
+struct gradeResult
+{
+    gradeRun explore;
+    gradeRun fast;
+    double total;           //fast.score + exploreWeight * explore.score
+};
+
+//runs both on sim, which must have its maze loaded and goal set. maxTicks bounds each run
+void gradeMaze(mazeSim &sim, const gradePenalties &penalties, long maxTicks, gradeResult &result);
+
+//one line of the leaderboard, the sums over every maze the solver ran
+struct gradeStanding
+{
+    gradeStanding() : mazes(0), explored(0), fastSolved(0), exploreScore(0), fastScore(0), penalty(0), total(0), extraMoves(0) {}
+    void add(const gradeResult &result);
+
+    std::string solver;
+    int mazes;
+    int explored;           //exploration runs that reached the goal
+    int fastSolved;
+    double exploreScore;
+    double fastScore;
+    double penalty;         //penalties in both runs, already in the scores
+    double total;
+    long extraMoves;
+};
+
+//best first: more fast runs finished, then the lower total
+void rankStandings(std::vector<gradeStanding> &standings);
+
+#endif // MAZEGRADER_H
@@ -0,0 +1,369 @@
+#include "mazeIO.h"
+#include "mazeParser.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <direct.h>
+#endif
+
+static_assert(sizeof(mazbHeader) == 64, "mazb header layout changed");
+
+mazeError readMazeFile(const char *fileName, baseMap &data, int *errorLine)
+{
+    //one parser per thread so batch loads reuse its scratch bits
+    static thread_local mazeTextParser parser;
+    mazeError err;
+
+#ifndef _WIN32
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0)
+    {
+        return MAZE_ERR_OPEN;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return MAZE_ERR_FORMAT;
+    }
+    void *addr = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(addr == MAP_FAILED)
+    {
+        return MAZE_ERR_OPEN;
+    }
+    err = parser.parse((const char *)addr, info.st_size, data);
+    munmap(addr, info.st_size);
+#else
+    FILE *inFile = fopen(fileName, "rb");
+    if(!inFile)
+    {
+        return MAZE_ERR_OPEN;
+    }
+    std::vector<char> text;
+    char chunk[65536];
+    size_t got;
+    while((got = fread(chunk, 1, sizeof(chunk), inFile)) > 0)
+    {
+        text.insert(text.end(), chunk, chunk + got);
+    }
+    fclose(inFile);
+    err = parser.parse(text.data(), text.size(), data);
+#endif
+
+    if(errorLine)
+    {
+        *errorLine = parser.errorLine();
+    }
+    return err;
+}
+
+bool isBinaryMazeName(const char *fileName)
+{
+    size_t len = strlen(fileName);
+    return len >= 5 && !strcmp(fileName + len - 5, ".mazb");
+}
+
+mazeError readMaze(const char *fileName, baseMap &data, int *errorLine)
+{
+    if(errorLine)
+    {
+        *errorLine = 0;
+    }
+    return isBinaryMazeName(fileName) ? readMazeBinary(fileName, data) : readMazeFile(fileName, data, errorLine);
+}
+
+mazeError writeMaze(const char *fileName, const baseMap &data)
+{
+    return isBinaryMazeName(fileName) ? writeMazeBinary(fileName, data) : writeMazeFile(fileName, data);
+}
+
+mazeError writeMazeFile(const char *fileName, const baseMap &data)
+{
+    FILE *outFile = fopen(fileName, "w");
+    if(!outFile)
+    {
+        return MAZE_ERR_OPEN;
+    }
+
+    //same order the original editor wrote, x major
+    for(int i = 0; i < data.width(); i++)
+    {
+        for(int j = 0; j < data.height(); j++)
+        {
+            fprintf(outFile, "%d %d %d %d %d %d\n", i+1, j+1, data.isWallTop(i, j), data.isWallBottom(i, j),
+                    data.isWallLeft(i, j), data.isWallRight(i, j));
+        }
+    }
+    return fclose(outFile) == 0 ? MAZE_OK : MAZE_ERR_OPEN;
+}
+
+//fnv-1a over whole words, fast enough to check a 1024x1024 maze on every load
+static uint64_t checksumWords(uint64_t hash, const uint64_t *words, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        hash = (hash ^ words[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t mazeChecksum(const baseMap &data)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = checksumWords(hash, data.wordsV(), baseMap::vWords(data.width(), data.height()));
+    return checksumWords(hash, data.wordsH(), baseMap::hWords(data.width(), data.height()));
+}
+
+mazeError writeMazeBinary(const char *fileName, const baseMap &data)
+{
+    FILE *outFile = fopen(fileName, "wb");
+    if(!outFile)
+    {
+        return MAZE_ERR_OPEN;
+    }
+
+    mazbHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAZB_MAGIC, 4);
+    header.version = MAZB_VERSION;
+    header.headerSize = sizeof(header);
+    header.byteOrder = MAZB_BYTE_ORDER;
+    header.width = data.width();
+    header.height = data.height();
+    header.startX = data.startX();
+    header.startY = data.startY();
+    header.goalX = data.hasGoal() ? data.goalX() : MAZB_NO_GOAL;
+    header.goalY = data.hasGoal() ? data.goalY() : MAZB_NO_GOAL;
+    header.vWords = baseMap::vWords(data.width(), data.height());
+    header.hWords = baseMap::hWords(data.width(), data.height());
+    header.checksum = mazeChecksum(data);
+
+    bool ok = fwrite(&header, sizeof(header), 1, outFile) == 1 &&
+              fwrite(data.wordsV(), sizeof(uint64_t), header.vWords, outFile) == header.vWords &&
+              fwrite(data.wordsH(), sizeof(uint64_t), header.hWords, outFile) == header.hWords;
+    return fclose(outFile) == 0 && ok ? MAZE_OK : MAZE_ERR_OPEN;
+}
+
+//checks everything in the header against itself and the file size
+static mazeError checkHeader(const mazbHeader *header, size_t fileSize)
+{
+    if(fileSize < sizeof(mazbHeader) || memcmp(header->magic, MAZB_MAGIC, 4))
+    {
+        return MAZE_ERR_FORMAT;
+    }
+    if(header->version != MAZB_VERSION || header->byteOrder != MAZB_BYTE_ORDER ||
+       header->headerSize != sizeof(mazbHeader))
+    {
+        return MAZE_ERR_VERSION;
+    }
+    if(header->width < 1 || header->width > MAZE_MAX_SIZE)
+    {
+        return MAZE_ERR_WIDTH;
+    }
+    if(header->height < 1 || header->height > MAZE_MAX_SIZE)
+    {
+        return MAZE_ERR_HEIGHT;
+    }
+    if(header->vWords != baseMap::vWords(header->width, header->height) ||
+       header->hWords != baseMap::hWords(header->width, header->height) ||
+       fileSize < sizeof(mazbHeader) + (header->vWords + header->hWords) * sizeof(uint64_t))
+    {
+        return MAZE_ERR_FORMAT;
+    }
+    if(header->startX >= header->width || header->startY >= header->height ||
+       (header->goalX != MAZB_NO_GOAL && (header->goalX >= header->width || header->goalY >= header->height)))
+    {
+        return MAZE_ERR_FORMAT;
+    }
+    return MAZE_OK;
+}
+
+mazeError readMazeBinary(const char *fileName, baseMap &data)
+{
+#ifndef _WIN32
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0)
+    {
+        return MAZE_ERR_OPEN;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(mazbHeader))
+    {
+        close(fd);
+        return MAZE_ERR_FORMAT;
+    }
+
+    //the mapping stays open as long as any baseMap still reads from it
+    size_t fileSize = info.st_size;
+    void *addr = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(addr == MAP_FAILED)
+    {
+        return MAZE_ERR_OPEN;
+    }
+    std::shared_ptr<const void> mapping(addr, [fileSize](const void *p) { munmap((void *)p, fileSize); });
+#else
+    //no mmap here, read the whole file into memory instead
+    FILE *inFile = fopen(fileName, "rb");
+    if(!inFile)
+    {
+        return MAZE_ERR_OPEN;
+    }
+    fseek(inFile, 0, SEEK_END);
+    size_t fileSize = ftell(inFile);
+    fseek(inFile, 0, SEEK_SET);
+    std::shared_ptr<uint64_t> buffer(new uint64_t[fileSize / sizeof(uint64_t) + 1], std::default_delete<uint64_t[]>());
+    size_t got = fread(buffer.get(), 1, fileSize, inFile);
+    fclose(inFile);
+    if(got != fileSize)
+    {
+        return MAZE_ERR_FORMAT;
+    }
+    std::shared_ptr<const void> mapping(buffer, buffer.get());
+#endif
+
+    const mazbHeader *header = (const mazbHeader *)mapping.get();
+    mazeError err = checkHeader(header, fileSize);
+    if(err != MAZE_OK)
+    {
+        return err;
+    }
+
+    const uint64_t *v = (const uint64_t *)(header + 1);
+    const uint64_t *h = v + header->vWords;
+    baseMap loaded;
+    loaded.adopt(header->width, header->height, v, h, mapping);
+    if(mazeChecksum(loaded) != header->checksum)
+    {
+        return MAZE_ERR_CHECKSUM;
+    }
+    loaded.setStart(header->startX, header->startY);
+    if(header->goalX != MAZB_NO_GOAL)
+    {
+        loaded.setGoal(header->goalX, header->goalY);
+    }
+    data = loaded;
+    return MAZE_OK;
+}
+
+bool findMazeFiles(const char *arg, std::vector<std::string> &files)
+{
+#ifdef _WIN32
+    files.push_back(arg);
+    return true;
+#else
+    std::string pattern = arg;
+    struct stat info;
+    int flags = 0;
+    glob_t found;
+    if(stat(arg, &info) == 0 && S_ISDIR(info.st_mode))
+    {
+        glob((pattern + "/*.mazb").c_str(), 0, NULL, &found);
+        flags = GLOB_APPEND;
+        pattern += "/*.maz";
+    }
+
+    int err = glob(pattern.c_str(), flags, NULL, &found);
+    bool matched = found.gl_pathc > 0 && (err == 0 || err == GLOB_NOMATCH);
+    if(matched)
+    {
+        for(size_t i = 0; i < found.gl_pathc; i++)
+        {
+            files.push_back(found.gl_pathv[i]);
+        }
+    }
+    globfree(&found);
+    return matched;
+#endif
+}
+
+bool makeMazeDir(const char *dir)
+{
+#ifdef _WIN32
+    return _mkdir(dir) == 0 || errno == EEXIST;
+#else
+    std::string path = dir;
+    struct stat info;
+    //every parent from the top down, the ones that are already there fail with EEXIST
+    for(size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1))
+    {
+        std::string part = path.substr(0, slash);
+        if(mkdir(part.c_str(), 0777) != 0 && errno != EEXIST)
+        {
+            return false;
+        }
+        if(slash == std::string::npos)
+        {
+            break;
+        }
+    }
+    return stat(dir, &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+bool parseMazeCell(const char *value, int &x, int &y)
+{
+    char end;
+    return sscanf(value, "%d,%d%c", &x, &y, &end) == 2 && x >= 1 && y >= 1 && x <= MAZE_MAX_SIZE && y <= MAZE_MAX_SIZE;
+}
+
+bool useDefaultGoal(baseMap &data)
+{
+    if(!data.hasGoal() && DEFAULT_GOAL_X < data.width() && DEFAULT_GOAL_Y < data.height())
+    {
+        data.setGoal(DEFAULT_GOAL_X, DEFAULT_GOAL_Y);
+    }
+    return data.hasGoal();
+}
+
+const char *mazeErrorString(mazeError err)
+{
+    switch(err)
+    {
+    case MAZE_OK:
+        return "Maze loaded";
+    case MAZE_ERR_FORMAT:
+        return "ERROR 201: file formating error";
+    case MAZE_ERR_OPEN:
+        return "ERROR 202: file not found";
+    case MAZE_ERR_WIDTH:
+        return "ERROR 204: maze file is wider than max maze size";
+    case MAZE_ERR_HEIGHT:
+        return "ERROR 205: maze file is taller than max maze size";
+    case MAZE_ERR_CHECKSUM:
+        return "ERROR 206: maze file is corrupt, checksum does not match";
+    case MAZE_ERR_VERSION:
+        return "ERROR 207: unsupported maze file version";
+    case MAZE_ERR_DUPLICATE:
+        return "ERROR 208: cell is in the maze file twice";
+    case MAZE_ERR_WALLS:
+        return "ERROR 209: wall does not match the neighbouring cell";
+    case MAZE_ERR_TRUNCATED:
+        return "ERROR 210: maze file is missing cells, it may be cut off";
+    case MAZE_ERR_OUTSIDE:
+        return "ERROR 211: cell is outside the maze size given by the last line, it may be cut off";
+    case MAZE_ERR_TRACE:
+        return "ERROR 212: not a run trace or it is damaged";
+    case MAZE_ERR_LINK:
+        return "ERROR 213: no answer from the mouse, check the address and that it is running";
+    case MAZE_ERR_PROTOCOL:
+        return "ERROR 214: the mouse speaks a different protocol version";
+    case MAZE_ERR_PLUGIN:
+        return "ERROR 215: not a solver plugin or it needs something that isn't there";
+    case MAZE_ERR_PLUGIN_ABI:
+        return "ERROR 216: solver plugin was built for a different plugin version";
+    case MAZE_ERR_NO_GOAL:
+        return "ERROR 217: maze has no goal and is too small for the default one";
+    case MAZE_ERR_GOAL_OUTSIDE:
+        return "ERROR 218: the goal given is outside the maze";
+    }
+    return "ERROR: unknown";
+}
@@ -0,0 +1,81 @@
+#ifndef MAZEIO_H
+#define MAZEIO_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include <string>
+#include <vector>
+
+//maze file errors, same numbers the GUI prints in the debug tab
+enum mazeError
+{
+    MAZE_OK = 0,
+    MAZE_ERR_FORMAT = 201,
+    MAZE_ERR_OPEN = 202,
+    MAZE_ERR_WIDTH = 204,
+    MAZE_ERR_HEIGHT = 205,
+    MAZE_ERR_CHECKSUM = 206,
+    MAZE_ERR_VERSION = 207,
+    MAZE_ERR_DUPLICATE = 208,
+    MAZE_ERR_WALLS = 209,
+    MAZE_ERR_TRUNCATED = 210,
+    MAZE_ERR_OUTSIDE = 211,
+    MAZE_ERR_TRACE = 212,
+    MAZE_ERR_LINK = 213,
+    MAZE_ERR_PROTOCOL = 214,
+    MAZE_ERR_PLUGIN = 215,
+    MAZE_ERR_PLUGIN_ABI = 216,
+    MAZE_ERR_NO_GOAL = 217,
+    MAZE_ERR_GOAL_OUTSIDE = 218
+};
+
+//Binary maze file (.mazb), little endian. The header is followed straight by the
+//baseMap wall words (v then h) so a mapped file can be used without copying.
+#define MAZB_MAGIC "MAZB"
+#define MAZB_VERSION 1
+#define MAZB_BYTE_ORDER 0x01020304u
+#define MAZB_NO_GOAL 0xFFFFFFFFu
+
+struct mazbHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t byteOrder;
+    uint32_t width;
+    uint32_t height;
+    uint32_t startX, startY;
+    uint32_t goalX, goalY;
+    uint32_t reserved;
+    uint64_t vWords;
+    uint64_t hWords;
+    uint64_t checksum;
+};
+
+//Qt free maze readers and writers for the GUI and the headless tools, the file
+//decides the maze size. Call mazeSim::mazeChanged() after loading into a sim.
+//data is only changed when the whole file loaded, errorLine gets the line a text
+//file went wrong on (0 when the error isn't about one line)
+mazeError readMaze(const char *fileName, baseMap &data, int *errorLine = NULL);
+mazeError readMazeFile(const char *fileName, baseMap &data, int *errorLine = NULL);
+mazeError readMazeBinary(const char *fileName, baseMap &data);
+mazeError writeMaze(const char *fileName, const baseMap &data);
+mazeError writeMazeFile(const char *fileName, const baseMap &data);
+mazeError writeMazeBinary(const char *fileName, const baseMap &data);
+
+bool isBinaryMazeName(const char *fileName);
+//for the command line tools, adds the .mazb and .maz files of a directory, a glob's
+//matches or a file name to files. False if arg matched nothing
+bool findMazeFiles(const char *arg, std::vector<std::string> &files);
+//makes dir and any missing parents, true if it is a directory afterwards
+bool makeMazeDir(const char *dir);
+//for the command line tools, a 1 based cell like --goal x,y. False unless x and y
+//are both 1 to MAZE_MAX_SIZE
+bool parseMazeCell(const char *value, int &x, int &y);
+//gives a maze without a goal DEFAULT_GOAL_X,Y, the cell the solvers head for then.
+//False if the maze still has no goal because that cell isn't in it
+bool useDefaultGoal(baseMap &data);
+uint64_t mazeChecksum(const baseMap &data);
+const char *mazeErrorString(mazeError err);
+
+#endif // MAZEIO_H
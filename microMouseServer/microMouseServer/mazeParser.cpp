@@ -0,0 +1,166 @@
+#include "mazeParser.h"
+
+//numbers bigger than this are a format error, keeps the digit loop from overflowing
+#define PARSE_INT_LIMIT 100000000
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+//reads one unsigned number off the current line, false if there isn't one
+static inline bool readInt(const char *&p, const char *end, int &value)
+{
+    while(p < end && isBlank(*p)) p++;
+    if(p == end || (unsigned)(*p - '0') > 9)
+    {
+        return false;
+    }
+    int v = 0;
+    while(p < end && (unsigned)(*p - '0') <= 9)
+    {
+        v = v*10 + (*p - '0');
+        if(v > PARSE_INT_LIMIT)
+        {
+            return false;
+        }
+        p++;
+    }
+    value = v;
+    return true;
+}
+
+//true if only blanks are left before the end of the line, moves p past the newline
+static inline bool endLine(const char *&p, const char *end)
+{
+    while(p < end && isBlank(*p)) p++;
+    if(p < end && *p != '\n')
+    {
+        return false;
+    }
+    if(p < end) p++;
+    return true;
+}
+
+//sets the wall bit if the neighbour hasn't been read yet, otherwise checks it agrees
+inline bool mazeTextParser::checkWall(uint64_t *words, size_t bit, size_t neighbour, int isWall)
+{
+    uint64_t mask = (uint64_t)1 << (bit & 63);
+    if(isSeen(neighbour))
+    {
+        return ((words[bit >> 6] & mask) != 0) == (isWall != 0);
+    }
+    words[bit >> 6] |= isWall ? mask : 0;
+    return true;
+}
+
+mazeTextParser::mazeTextParser()
+{
+    _errorLine = 0;
+}
+
+int mazeTextParser::errorLine()
+{
+    return _errorLine;
+}
+
+mazeError mazeTextParser::fail(mazeError err, int line)
+{
+    _errorLine = line;
+    return err;
+}
+
+mazeError mazeTextParser::parse(const char *text, size_t length, baseMap &data)
+{
+    const char *end = text + length;
+    _errorLine = 0;
+
+    //the size comes from the last line that isn't blank
+    const char *last = end;
+    while(last > text && (isBlank(last[-1]) || last[-1] == '\n')) last--;
+    while(last > text && last[-1] != '\n') last--;
+    int width, height;
+    if(!readInt(last, end, width) || !readInt(last, end, height) || width < 1 || height < 1)
+    {
+        int line = 1;
+        for(const char *p = text; p < last; p++) line += *p == '\n';
+        return fail(MAZE_ERR_FORMAT, line);
+    }
+    if(width > MAZE_MAX_SIZE)
+    {
+        return fail(MAZE_ERR_WIDTH, 0);
+    }
+    if(height > MAZE_MAX_SIZE)
+    {
+        return fail(MAZE_ERR_HEIGHT, 0);
+    }
+
+    size_t cells = (size_t)width*height;
+    _seen.assign(cells/64 + 1, 0);
+    _loaded.resize(width, height);
+
+    uint64_t *v = _loaded.mutableWordsV();
+    uint64_t *h = _loaded.mutableWordsH();
+    size_t found = 0;
+    int line = 0;
+    const char *p = text;
+    while(p < end)
+    {
+        line++;
+        const char *start = p;
+        if(endLine(p, end))
+        {
+            //blank line
+            continue;
+        }
+        p = start;
+
+        int x, y, wall[4];
+        if(!readInt(p, end, x) || !readInt(p, end, y) ||
+           !readInt(p, end, wall[TOP]) || !readInt(p, end, wall[BOTTOM]) ||
+           !readInt(p, end, wall[LEFT]) || !readInt(p, end, wall[RIGHT]) ||
+           !endLine(p, end) || x < 1 || y < 1 || (wall[TOP] | wall[BOTTOM] | wall[LEFT] | wall[RIGHT]) > 1)
+        {
+            return fail(MAZE_ERR_FORMAT, line);
+        }
+        if(x > width || y > height)
+        {
+            return fail(MAZE_ERR_OUTSIDE, line);
+        }
+
+        x--;
+        y--;
+        size_t cell = (size_t)y*width + x;
+        size_t vRow = (size_t)y*(width-1);
+        size_t hRow = (size_t)y*width;
+        if(isSeen(cell))
+        {
+            return fail(MAZE_ERR_DUPLICATE, line);
+        }
+        _seen[cell >> 6] |= (uint64_t)1 << (cell & 63);
+        found++;
+
+        //the first cell to mention a wall sets it, its neighbour has to agree.
+        //Outside walls aren't stored and always have to be there, an open one on
+        //the top or right edge means the last line wasn't really the corner
+        if((x == 0 && !wall[LEFT]) || (y == 0 && !wall[BOTTOM]))
+        {
+            return fail(MAZE_ERR_WALLS, line);
+        }
+        if((x == width-1 && !wall[RIGHT]) || (y == height-1 && !wall[TOP]))
+        {
+            return fail(MAZE_ERR_TRUNCATED, line);
+        }
+        if(x > 0 && !checkWall(v, vRow + x - 1, cell - 1, wall[LEFT])) return fail(MAZE_ERR_WALLS, line);
+        if(x < width-1 && !checkWall(v, vRow + x, cell + 1, wall[RIGHT])) return fail(MAZE_ERR_WALLS, line);
+        if(y > 0 && !checkWall(h, hRow + x - width, cell - width, wall[BOTTOM])) return fail(MAZE_ERR_WALLS, line);
+        if(y < height-1 && !checkWall(h, hRow + x, cell + width, wall[TOP])) return fail(MAZE_ERR_WALLS, line);
+    }
+
+    if(found != cells)
+    {
+        return fail(MAZE_ERR_TRUNCATED, line);
+    }
+    data.swap(_loaded);
+    return MAZE_OK;
+}
@@ -0,0 +1,35 @@
+#ifndef MAZEPARSER_H
+#define MAZEPARSER_H
+
+#include "mazeBase.h"
+#include "mazeIO.h"
+#include <stddef.h>
+#include <vector>
+
+//Single pass parser for the text .maz format, works straight on the file bytes.
+//Every line is "x y top bottom left right", 1 based. The maze size is taken from
+//the last line, which is the far corner cell in every file the editor writes.
+//Besides the format it checks that every cell shows up exactly once and that both
+//sides of every wall agree, errorLine() says where it went wrong.
+//It needs a seen bit per cell and a map to parse into, both kept between calls.
+//The map is swapped with data on success, so a caller that also reuses data for a
+//whole corpus doesn't allocate anything past the largest maze.
+class mazeTextParser
+{
+public:
+    mazeTextParser();
+
+    mazeError parse(const char *text, size_t length, baseMap &data);
+    int errorLine();
+
+private:
+    mazeError fail(mazeError err, int line);
+    bool checkWall(uint64_t *words, size_t bit, size_t neighbour, int isWall);
+    bool isSeen(size_t cell) { return (_seen[cell >> 6] >> (cell & 63)) & 1; }
+
+    std::vector<uint64_t> _seen;
+    baseMap _loaded;    //data's old walls after a parse, their storage is reused next time
+    int _errorLine;
+};
+
+#endif // MAZEPARSER_H
@@ -0,0 +1,498 @@
+#include "mazeSim.h"
+#include "runTrace.h"
+#include "robotLink.h"
+#include "studentai.h"
+#include <chrono>
+
+//relativeWalls[heading][absolute mask] turns bit (1 << mDirection) into relativeWall bits
+static const uint8_t relativeWalls[4][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    { 0,  8,  1,  9,  2, 10,  3, 11,  4, 12,  5, 13,  6, 14,  7, 15},
+    { 0,  4,  8, 12,  1,  5,  9, 13,  2,  6, 10, 14,  3,  7, 11, 15},
+    { 0,  2,  4,  6,  8, 10, 12, 14,  1,  3,  5,  7,  9, 11, 13, 15}
+};
+
+motionCost::motionCost()
+{
+    cell = MOVE_CELL_MS;
+    fastCell = MOVE_FAST_CELL_MS;
+    accel = MOVE_ACCEL_MS;
+    turn = TURN_MS;
+    uTurn = UTURN_MS;
+}
+
+int motionCost::cellCost(int k) const
+{
+    long cost = cell - (long)k*accel;
+    return cost < fastCell ? fastCell : (int)cost;
+}
+
+long motionCost::runCost(int cells) const
+{
+    long total = 0;
+    for(int k = 0; k < cells; k++)
+    {
+        total += this->cellCost(k);
+    }
+    return total;
+}
+
+mazeSim::mazeSim() : _student(new studentSolver)
+{
+    _solver = _student.get();
+    _listener = NULL;
+    _trace = NULL;
+    _timing = false;
+    _robot = NULL;
+    _robotWalls = -1;
+    this->clearMaze();
+    this->resetMouse();
+}
+
+mazeSim::~mazeSim()
+{
+}
+
+void mazeSim::clearMaze()
+{
+    //open maze with only the outside walls
+    this->mazeData.clear();
+    this->mazeChanged();
+}
+
+//tells the AI to forget its map on the next tick, call after loading a different maze
+void mazeSim::mazeChanged()
+{
+    _newMaze = true;
+}
+
+void mazeSim::resetMouse()
+{
+    _x = this->mazeData.startX();
+    _y = this->mazeData.startY();
+    _dir = dUP;
+    _finished = false;
+    _stats.clear();
+    _robotWalls = -1;
+    if(_robot) _robot->queue(ROBOT_RESET);
+    _visited.assign(((size_t)this->mazeData.width()*this->mazeData.height() + 63) / 64, 0);
+    this->visit();
+    _straight = 0;
+    _lastTurn = 0;
+    if(_trace) _trace->begin(this->mazeData, _dir);
+}
+
+//goal is 1 based like the mouse position and overrides the one from the maze file.
+//A run is only solved by calling foundFinish on it, see isSolved()
+void mazeSim::setGoal(int x, int y)
+{
+    this->mazeData.setGoal(x-1, y-1);
+}
+
+void mazeSim::setListener(simListener *listener)
+{
+    _listener = listener;
+}
+
+void mazeSim::setTrace(runTrace *trace)
+{
+    _trace = trace;
+}
+
+void mazeSim::setMotionCost(const motionCost &cost)
+{
+    _cost = cost;
+}
+
+const motionCost &mazeSim::motionCosts() const
+{
+    return _cost;
+}
+
+//the solver may have last seen another maze, isNewMaze() tells it to start over
+void mazeSim::setSolver(mazeSolver *solver)
+{
+    if(!solver)
+    {
+        solver = _student.get();
+    }
+    if(solver != _solver)
+    {
+        _solver = solver;
+        this->mazeChanged();
+    }
+}
+
+mazeSolver *mazeSim::solver()
+{
+    return _solver;
+}
+
+void mazeSim::tick()
+{
+    if(!_finished)
+    {
+        this->callAI();
+    }
+}
+
+//one tick, timed into the histogram when timing is on. The rules allow one
+//moveForward per tick, every one past that is counted
+void mazeSim::callAI()
+{
+    _stats.aiCalls++;
+    if(_trace) _trace->record(TRACE_TICK);
+    long movesBefore = _stats.moves + _stats.blocked;
+    solverContext mouse(*this);
+    if(!_timing)
+    {
+        _solver->tick(mouse);
+    }
+    else
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        _solver->tick(mouse);
+        _stats.addCall(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    long moved = _stats.moves + _stats.blocked - movesBefore;
+    if(moved > 1)
+    {
+        _stats.crowdedTicks++;
+        _stats.extraMoves += moved - 1;
+    }
+    if(moved > _stats.maxTickMoves)
+    {
+        _stats.maxTickMoves = moved;
+    }
+}
+
+long mazeSim::run(long maxTicks)
+{
+    long ticks = 0;
+    while(!_finished && ticks < maxTicks)
+    {
+        this->callAI();
+        ticks++;
+    }
+    return ticks;
+}
+
+bool mazeSim::isFinished()
+{
+    return _finished;
+}
+
+bool mazeSim::isSolved()
+{
+    return _finished && _x == this->goalX() && _y == this->goalY();
+}
+
+//mouse position is 1 based to match the maze files
+int mazeSim::mouseX()
+{
+    return _x + 1;
+}
+
+int mazeSim::mouseY()
+{
+    return _y + 1;
+}
+
+mDirection mazeSim::mouseDir()
+{
+    return _dir;
+}
+
+long mazeSim::tickCount()
+{
+    return _stats.aiCalls;
+}
+
+long mazeSim::stepCount()
+{
+    return _stats.moves;
+}
+
+long mazeSim::turnCount()
+{
+    return _stats.turns;
+}
+
+long mazeSim::sensorCount()
+{
+    return _stats.sensors;
+}
+
+const runStats &mazeSim::stats() const
+{
+    return _stats;
+}
+
+void mazeSim::setTiming(bool timing)
+{
+    _timing = timing;
+}
+
+void mazeSim::visit()
+{
+    size_t cell = (size_t)_y*this->mazeData.width() + _x;
+    //a maze swapped in without resetMouse() has no bits yet
+    if((cell >> 6) >= _visited.size())
+    {
+        return;
+    }
+    uint64_t bit = (uint64_t)1 << (cell & 63);
+    _stats.cellsVisited += !(_visited[cell >> 6] & bit);
+    _visited[cell >> 6] |= bit;
+}
+
+long mazeSim::runTime()
+{
+    return _stats.runTime;
+}
+
+void mazeSim::setRobot(robotLink *robot)
+{
+    _robot = robot;
+    _robotWalls = -1;
+}
+
+//A real mouse is only asked once it has moved to a new cell, turning on the spot
+//doesn't change the walls. Queued moves and turns go out with that question
+int mazeSim::cellWalls()
+{
+    if(!_robot)
+    {
+        return this->mazeData.wallMask(_x, _y);
+    }
+    if(_robotWalls < 0)
+    {
+        long blocked = _robot->blockedMoves();
+        int relative = _robot->exchange();
+        if(relative < 0)
+        {
+            this->lostRobot();
+            return 15;
+        }
+        if(_robot->blockedMoves() > blocked)
+        {
+            this->printUI("The mouse ran into a wall, it may not be where the maze view shows it.");
+        }
+        //rotating by -heading turns relativeWall bits back into mDirection bits
+        _robotWalls = relativeWalls[(4 - _dir) & 3][relative];
+    }
+    return _robotWalls;
+}
+
+void mazeSim::lostRobot()
+{
+    this->printUI("Lost the link to the mouse.");
+    _robot = NULL;
+    _finished = true;
+    if(_listener) _listener->simFinished();
+}
+
+bool mazeSim::isWall(mDirection direction)
+{
+    if(_robot)
+    {
+        return (this->cellWalls() >> direction) & 1;
+    }
+    switch (direction) {
+    case dUP:
+        return this->mazeData.isWallTop(_x, _y);
+    case dDOWN:
+        return this->mazeData.isWallBottom(_x, _y);
+    case dLEFT:
+        return this->mazeData.isWallLeft(_x, _y);
+    case dRIGHT:
+        return this->mazeData.isWallRight(_x, _y);
+    }
+    return true;
+}
+
+//directions are in clockwise order so turning is just +/-1 mod 4
+bool mazeSim::isWallForward()
+{
+    _stats.sensors++;
+    bool wall = isWall(_dir);
+    if(_trace) _trace->record(traceEvent(TRACE_SENSE_FORWARD + wall));
+    return wall;
+}
+
+bool mazeSim::isWallLeft()
+{
+    _stats.sensors++;
+    bool wall = isWall(mDirection((_dir + 3) & 3));
+    if(_trace) _trace->record(traceEvent(TRACE_SENSE_LEFT + wall));
+    return wall;
+}
+
+bool mazeSim::isWallRight()
+{
+    _stats.sensors++;
+    bool wall = isWall(mDirection((_dir + 1) & 3));
+    if(_trace) _trace->record(traceEvent(TRACE_SENSE_RIGHT + wall));
+    return wall;
+}
+
+bool mazeSim::moveForward()
+{
+    if(isWall(_dir))
+    {
+        _stats.blocked++;
+        if(_trace) _trace->record(TRACE_BLOCKED);
+        return false;
+    }
+
+    switch (_dir) {
+    case dUP:
+        _y++;
+        break;
+    case dDOWN:
+        _y--;
+        break;
+    case dLEFT:
+        _x--;
+        break;
+    case dRIGHT:
+        _x++;
+        break;
+    }
+    _stats.moves++;
+    this->visit();
+    if(_robot)
+    {
+        _robot->queue(ROBOT_FORWARD);
+        _robotWalls = -1;
+    }
+    _stats.runTime += _cost.cellCost(_straight++);
+    _lastTurn = 0;
+    if(_trace) _trace->record(TRACE_FORWARD);
+    return true;
+}
+
+void mazeSim::turnLeft()
+{
+    _stats.turns++;
+    this->chargeTurn(-1);
+    _dir = mDirection((_dir + 3) & 3);
+    if(_robot) _robot->queue(ROBOT_LEFT);
+    if(_trace) _trace->record(TRACE_LEFT);
+}
+
+void mazeSim::turnRight()
+{
+    _stats.turns++;
+    this->chargeTurn(1);
+    _dir = mDirection((_dir + 1) & 3);
+    if(_robot) _robot->queue(ROBOT_RIGHT);
+    if(_trace) _trace->record(TRACE_RIGHT);
+}
+
+
+int mazeSim::senseWalls()
+{
+    _stats.sensors++;
+    if(_trace) _trace->record(TRACE_SENSE_CELL);
+    return this->cellWalls();
+}
+
+int mazeSim::senseWallsRelative()
+{
+    return relativeWalls[_dir][this->senseWalls()];
+}
+
+void mazeSim::turnTo(mDirection dir)
+{
+    switch((dir - _dir) & 3)
+    {
+    case 1:
+        this->turnRight();
+        break;
+    case 2:
+        this->turnRight();
+        this->turnRight();
+        break;
+    case 3:
+        this->turnLeft();
+        break;
+    }
+}
+
+bool mazeSim::moveDirection(mDirection dir)
+{
+    this->turnTo(dir);
+    return this->moveForward();
+}
+
+//two turns the same way in a row are one u-turn
+void mazeSim::chargeTurn(int way)
+{
+    if(_lastTurn == way)
+    {
+        _stats.runTime += _cost.uTurn - _cost.turn;
+        _lastTurn = 0;
+    }
+    else
+    {
+        _stats.runTime += _cost.turn;
+        _lastTurn = way;
+    }
+    _straight = 0;
+}
+
+void mazeSim::foundFinish()
+{
+    //the last moves are still queued, let the mouse catch up
+    if(_robot && _robot->hasQueued() && _robot->exchange() < 0)
+    {
+        this->printUI("Lost the link to the mouse.");
+    }
+    _finished = true;
+    if(_trace) _trace->record(TRACE_FINISH);
+    if(_listener) _listener->simFinished();
+}
+
+void mazeSim::printUI(const char *mesg)
+{
+    if(_trace) _trace->recordPrint(mesg);
+    if(_listener) _listener->simPrint(mesg);
+}
+
+int mazeSim::mazeWidth()
+{
+    return this->mazeData.width();
+}
+
+int mazeSim::mazeHeight()
+{
+    return this->mazeData.height();
+}
+
+bool mazeSim::isNewMaze()
+{
+    bool isNew = _newMaze;
+    _newMaze = false;
+    return isNew;
+}
+
+int mazeSim::startX()
+{
+    return this->mazeData.startX();
+}
+
+int mazeSim::startY()
+{
+    return this->mazeData.startY();
+}
+
+int mazeSim::goalX()
+{
+    return this->mazeData.hasGoal() ? this->mazeData.goalX() : DEFAULT_GOAL_X;
+}
+
+int mazeSim::goalY()
+{
+    return this->mazeData.hasGoal() ? this->mazeData.goalY() : DEFAULT_GOAL_Y;
+}
@@ -0,0 +1,184 @@
+#ifndef MAZESIM_H
+#define MAZESIM_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include "runStats.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class runTrace;
+class robotLink;
+class mazeSolver;
+
+//how long the motion primitives take on the real robot, in ms. Cell k (0 based) of
+//a straight run takes max(fastCell, cell - k*accel), turning stops the run
+struct motionCost
+{
+    motionCost();
+
+    int cell;
+    int fastCell;
+    int accel;
+    int turn;           //90 degrees
+    int uTurn;          //180 degrees, charged instead of a second turn the same way
+
+    int cellCost(int k) const;
+    long runCost(int cells) const;
+};
+
+//bits of senseWallsRelative(), around the way the mouse faces
+enum relativeWall
+{
+    WALL_FORWARD = 1,
+    WALL_RIGHT = 2,
+    WALL_BACK = 4,
+    WALL_LEFT = 8
+};
+
+//receives everything the AI reports during a run, the GUI implements this to watch the sim
+class simListener
+{
+public:
+    virtual ~simListener() {}
+    virtual void simPrint(const char *mesg) = 0;
+    virtual void simFinished() = 0;
+};
+
+//headless simulation core, owns the maze and the mouse pose. No Qt in here so
+//the AI can be stepped as fast as the cpu allows, the GUI only draws what it sees
+class mazeSim
+{
+public:
+    mazeSim();
+    ~mazeSim();
+
+    baseMap mazeData;
+
+    void clearMaze();
+    void mazeChanged();
+    void resetMouse();
+    void setGoal(int x, int y);
+    void setListener(simListener *listener);
+    //records every run into trace from the next resetMouse() on, NULL stops recording
+    void setTrace(runTrace *trace);
+    void setMotionCost(const motionCost &cost);
+    const motionCost &motionCosts() const;
+
+    void tick();
+    long run(long maxTicks);
+    //foundFinish() was called, wherever the mouse was
+    bool isFinished();
+    //finished on the goal, DEFAULT_GOAL_X,Y for a maze without one
+    bool isSolved();
+
+    int mouseX();
+    int mouseY();
+    mDirection mouseDir();
+
+    //run counters, cleared by resetMouse()
+    long tickCount();
+    long stepCount();
+    long turnCount();
+    long sensorCount();
+    //estimated time on the robot in ms, the sum of what every move and turn cost
+    long runTime();
+    //everything above and more, see runStats.h
+    const runStats &stats() const;
+    //times every studentAI() call into stats().histogram, off by default
+    void setTiming(bool timing);
+    //drives a real mouse instead, NULL goes back to mazeData. The pose is still
+    //tracked here but the walls come from the mouse's sensors
+    void setRobot(robotLink *robot);
+    //the AI that drives the mouse, NULL goes back to this sim's own studentAI. Not
+    //owned. Don't swap it while a simRunner is running the sim
+    void setSolver(mazeSolver *solver);
+    mazeSolver *solver();
+
+private:
+    //mazeBench times the student api directly
+    friend class sensorBench;
+    friend class solverContext;
+
+    //student api, see mazeSolver.h
+    bool isWallLeft();
+    bool isWallRight();
+    bool isWallForward();
+    bool moveForward();
+    void turnLeft();
+    void turnRight();
+    //all walls of the mouse's cell for one sensor call, bit (1 << mDirection) per wall
+    int senseWalls();
+    //same walls as relativeWall bits
+    int senseWallsRelative();
+    //faces dir the short way round and moves one cell, false if a wall is in the way
+    bool moveDirection(mDirection dir);
+    void turnTo(mDirection dir);
+    void foundFinish();
+    void printUI(const char *mesg);
+    int mazeWidth();
+    int mazeHeight();
+    bool isNewMaze();
+    //0 based start and goal cells, the goal is DEFAULT_GOAL_X,Y when the maze has none
+    int startX();
+    int startY();
+    int goalX();
+    int goalY();
+
+    bool isWall(mDirection direction);
+    void chargeTurn(int way);
+    void callAI();
+    void visit();
+    int cellWalls();
+    void lostRobot();
+
+    int _x, _y;
+    mDirection _dir;
+    bool _finished;
+    bool _newMaze;
+    runStats _stats;
+    std::vector<uint64_t> _visited;     //cells the mouse has stood on this run
+    bool _timing;
+    motionCost _cost;
+    robotLink *_robot;
+    int _robotWalls;    //walls of the mouse's cell as bit (1 << mDirection), -1 until the mouse says
+    int _straight;      //cells moved since the last turn
+    int _lastTurn;      //-1 left, 1 right, 0 if the last motion wasn't a turn
+    simListener *_listener;
+    runTrace *_trace;
+    mazeSolver *_solver;
+    std::unique_ptr<mazeSolver> _student;
+};
+
+//the student api of one mazeSim, what a mazeSolver drives the mouse with
+class solverContext
+{
+public:
+    explicit solverContext(mazeSim &sim) : _sim(sim) {}
+
+    bool isWallLeft() { return _sim.isWallLeft(); }
+    bool isWallRight() { return _sim.isWallRight(); }
+    bool isWallForward() { return _sim.isWallForward(); }
+    bool moveForward() { return _sim.moveForward(); }
+    void turnLeft() { _sim.turnLeft(); }
+    void turnRight() { _sim.turnRight(); }
+    int senseWalls() { return _sim.senseWalls(); }
+    int senseWallsRelative() { return _sim.senseWallsRelative(); }
+    bool moveDirection(mDirection dir) { return _sim.moveDirection(dir); }
+    void turnTo(mDirection dir) { _sim.turnTo(dir); }
+    void foundFinish() { _sim.foundFinish(); }
+    void printUI(const char *mesg) { _sim.printUI(mesg); }
+    int mazeWidth() { return _sim.mazeWidth(); }
+    int mazeHeight() { return _sim.mazeHeight(); }
+    bool isNewMaze() { return _sim.isNewMaze(); }
+    int startX() { return _sim.startX(); }
+    int startY() { return _sim.startY(); }
+    int goalX() { return _sim.goalX(); }
+    int goalY() { return _sim.goalY(); }
+
+private:
+    mazeSim &_sim;
+};
+
+#endif // MAZESIM_H
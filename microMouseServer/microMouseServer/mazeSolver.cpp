@@ -0,0 +1,28 @@
+#include "mazeSolver.h"
+#include "studentai.h"
+#include "floodSolver.h"
+
+std::vector<solverEntry> &solverRegistry()
+{
+    static std::vector<solverEntry> solvers = {
+        {"studentAI", []() -> mazeSolver * { return new studentSolver; }},
+        {"flood", []() -> mazeSolver * { return new floodSolver; }},
+#ifdef SOLVER_COROUTINES
+        {"floodTask", []() -> mazeSolver * { return new floodTaskSolver; }},
+#endif
+    };
+    return solvers;
+}
+
+const solverEntry *findSolver(const std::string &name)
+{
+    std::vector<solverEntry> &solvers = solverRegistry();
+    for(size_t i = 0; i < solvers.size(); i++)
+    {
+        if(solvers[i].name == name)
+        {
+            return &solvers[i];
+        }
+    }
+    return NULL;
+}
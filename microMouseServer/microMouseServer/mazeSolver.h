@@ -0,0 +1,65 @@
+#ifndef MAZESOLVER_H
+#define MAZESOLVER_H
+
+#include "mazeSim.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+//Base class of every AI. All of its memory lives in the object, so any number of
+//them can run at once, one per mazeSim. studentAI() is called once a tick with the
+//student api below driving the mouse of the sim that called it.
+class mazeSolver
+{
+public:
+    mazeSolver() : _mouse(NULL) {}
+    virtual ~mazeSolver() {}
+
+    //one tick on the mouse behind mouse, mazeSim calls this
+    void tick(solverContext &mouse)
+    {
+        _mouse = &mouse;
+        this->studentAI();
+    }
+
+protected:
+    virtual void studentAI() = 0;
+
+    //student api, see studentai.cpp
+    bool isWallLeft() { return _mouse->isWallLeft(); }
+    bool isWallRight() { return _mouse->isWallRight(); }
+    bool isWallForward() { return _mouse->isWallForward(); }
+    bool moveForward() { return _mouse->moveForward(); }
+    void turnLeft() { _mouse->turnLeft(); }
+    void turnRight() { _mouse->turnRight(); }
+    int senseWalls() { return _mouse->senseWalls(); }
+    int senseWallsRelative() { return _mouse->senseWallsRelative(); }
+    bool moveDirection(mDirection dir) { return _mouse->moveDirection(dir); }
+    void turnTo(mDirection dir) { _mouse->turnTo(dir); }
+    void foundFinish() { _mouse->foundFinish(); }
+    void printUI(const char *mesg) { _mouse->printUI(mesg); }
+    int mazeWidth() { return _mouse->mazeWidth(); }
+    int mazeHeight() { return _mouse->mazeHeight(); }
+    bool isNewMaze() { return _mouse->isNewMaze(); }
+    int startX() { return _mouse->startX(); }
+    int startY() { return _mouse->startY(); }
+    int goalX() { return _mouse->goalX(); }
+    int goalY() { return _mouse->goalY(); }
+
+private:
+    solverContext *_mouse;
+};
+
+//a solver the tools can pick by name
+struct solverEntry
+{
+    std::string name;
+    std::function<mazeSolver *()> create;
+};
+
+//every solver there is, studentAI first
+std::vector<solverEntry> &solverRegistry();
+//NULL if no solver has that name
+const solverEntry *findSolver(const std::string &name);
+
+#endif // MAZESOLVER_H
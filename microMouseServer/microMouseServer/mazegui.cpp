@@ -1,6 +1,7 @@
 #include "mazeConst.h"
 #include "mazegui.h"
 #include<QGraphicsSceneMoveEvent>
+#include<QtAlgorithms>
 
 mazeGui::mazeGui(QObject *parent) :
     QGraphicsScene(parent)
@@ -17,9 +18,15 @@ mazeGui::mazeGui(QObject *parent) :
     this->_bgGrid = this->createItemGroup(this->selectedItems());
     this->mazeWalls = this->createItemGroup(this->selectedItems());
     this->_mouse = NULL;
+    this->_border = NULL;
+    this->_selection = NULL;
+    this->_drag = DRAG_NONE;
+    this->_dragWall = true;
 
     //Generate maze window
-    this->setSceneRect(QRectF(QPoint(0,0), QPoint(MAZE_WIDTH_PX,MAZE_HEIGHT_PX)));
+    _width = DEFAULT_MAZE_WIDTH;
+    _height = DEFAULT_MAZE_HEIGHT;
+    this->setSceneRect(QRectF(QPoint(0,0), QPoint(_width*PX_PER_UNIT,_height*PX_PER_UNIT)));
 
     _mousePos.setX(1);
     _mousePos.setY(1);
@@ -35,82 +42,102 @@ mazeGui::~mazeGui()
     delete _bgGrid;
     delete mazeWalls;
     delete _mouse;
+    delete _selection;
 }
 
-void mazeGui::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
+//the wall under pos and the cell it was clicked from, the middle third of a cell's
+//side picks that side. False in a corner or the middle of the cell
+bool mazeGui::edgeAt(QPointF pos, QPoint &cell, Wall &wall)
 {
-    //check if mouse event is a left click inside of the maze
-    if(mouseEvent->button() == Qt::LeftButton &&
-            mouseEvent->scenePos().x() > 0 &&
-            mouseEvent->scenePos().y() > 0 &&
-            mouseEvent->scenePos().x() < MAZE_WIDTH_PX &&
-            mouseEvent->scenePos().y() < MAZE_HEIGHT_PX)
+    if(pos.x() <= 0 || pos.y() <= 0 || pos.x() >= _width*PX_PER_UNIT || pos.y() >= _height*PX_PER_UNIT)
     {
+        return false;
+    }
 
-        int xmod = (int)mouseEvent->scenePos().x() % PX_PER_UNIT;
-        int ymod = (int)mouseEvent->scenePos().y() % PX_PER_UNIT;
-        int xpos = (int)mouseEvent->scenePos().x() / PX_PER_UNIT;
-        int ypos = (int)mouseEvent->scenePos().y() / PX_PER_UNIT;
+    int xmod = (int)pos.x() % PX_PER_UNIT;
+    int ymod = (int)pos.y() % PX_PER_UNIT;
+    cell = QPoint((int)pos.x() / PX_PER_UNIT, (int)pos.y() / PX_PER_UNIT);
 
-        //This needs to be redone so it is more robust, missed clicks when x/ymod=0;
-        if((xmod < PX_PER_UNIT/3  || xmod > 2*PX_PER_UNIT/3 )&& ymod > PX_PER_UNIT/3  && ymod < 2*PX_PER_UNIT/3)
-        {
-            if(xmod >= PX_PER_UNIT /2)
-            {
-                emit passRightWall(QPoint(xpos, ypos));
-            }
-            else
-            {
-                emit passLeftWall(QPoint(xpos, ypos));
-            }
-        }
-        else if((ymod < PX_PER_UNIT/3  || ymod > 2*PX_PER_UNIT/3 )&& xmod > PX_PER_UNIT/3  && xmod < 2*PX_PER_UNIT/3)
-        {
-            if(ymod >= PX_PER_UNIT/2 || ymod == 0)
-            {
-                emit passTopWall(QPoint(xpos, ypos));
-            }
-            else
-            {
-                emit passBottomWall(QPoint(xpos, ypos));
-            }
-        }
+    //This needs to be redone so it is more robust, missed clicks when x/ymod=0;
+    if((xmod < PX_PER_UNIT/3  || xmod > 2*PX_PER_UNIT/3 )&& ymod > PX_PER_UNIT/3  && ymod < 2*PX_PER_UNIT/3)
+    {
+        wall = xmod >= PX_PER_UNIT/2 ? RIGHT : LEFT;
+        return true;
     }
-    //checks for right clicks, very inefficient since the bound checks are done twice.
-    else if(mouseEvent->button() == Qt::RightButton &&
-            mouseEvent->scenePos().x() > 0 &&
-            mouseEvent->scenePos().y() > 0 &&
-            mouseEvent->scenePos().x() <= MAZE_WIDTH_PX &&
-            mouseEvent->scenePos().y() <= MAZE_HEIGHT_PX)
+    if((ymod < PX_PER_UNIT/3  || ymod > 2*PX_PER_UNIT/3 )&& xmod > PX_PER_UNIT/3  && xmod < 2*PX_PER_UNIT/3)
     {
+        wall = ymod >= PX_PER_UNIT/2 || ymod == 0 ? TOP : BOTTOM;
+        return true;
+    }
+    return false;
+}
 
-        int xmod = (int)mouseEvent->scenePos().x() % PX_PER_UNIT;
-        int ymod = (int)mouseEvent->scenePos().y() % PX_PER_UNIT;
-        int xpos = (int)mouseEvent->scenePos().x() / PX_PER_UNIT;
-        int ypos = (int)mouseEvent->scenePos().y() / PX_PER_UNIT;
+QPoint mazeGui::cellAt(QPointF pos)
+{
+    int x = qBound(0, (int)(pos.x() / PX_PER_UNIT), _width - 1);
+    int y = qBound(0, (int)(pos.y() / PX_PER_UNIT), _height - 1);
+    return QPoint(x, y);
+}
 
-        if((xmod < PX_PER_UNIT/3  || xmod > 2*PX_PER_UNIT/3 )&& ymod > PX_PER_UNIT/3  && ymod < 2*PX_PER_UNIT/3)
-        {
-            if(xmod >= PX_PER_UNIT /2)
-            {
-                emit takeRightWall(QPoint(xpos, ypos));
-            }
-            else
-            {
-                emit takeLeftWall(QPoint(xpos, ypos));
-            }
-        }
-        else if((ymod < PX_PER_UNIT/3  || ymod > 2*PX_PER_UNIT/3 )&& xmod > PX_PER_UNIT/3  && xmod < 2*PX_PER_UNIT/3)
-        {
-            if(ymod >= PX_PER_UNIT/2 || ymod == 0)
-            {
-                emit takeTopWall(QPoint(xpos, ypos));
-            }
-            else
-            {
-                emit takeBottomWall(QPoint(xpos, ypos));
-            }
-        }
+void mazeGui::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
+{
+    if(_drag != DRAG_NONE || (mouseEvent->button() != Qt::LeftButton && mouseEvent->button() != Qt::RightButton))
+    {
+        return;
+    }
+    _dragWall = mouseEvent->button() == Qt::LeftButton;
+
+    if(mouseEvent->modifiers() & Qt::ShiftModifier)
+    {
+        _drag = DRAG_RECT;
+        _rectStart = this->cellAt(mouseEvent->scenePos());
+        _selection = this->addRect(QRectF(), *_guidePen, QBrush(QColor(0xFF, 0xFF, 0xFF, 0x30)));
+        this->mouseMoveEvent(mouseEvent);
+        return;
+    }
+
+    _drag = DRAG_STROKE;
+    emit strokeStarted();
+    _lastCell = QPoint(-1, -1);
+    this->mouseMoveEvent(mouseEvent);
+}
+
+//a stroke edits each wall it passes once, the same wall is only sent again after
+//the pointer has been over another one
+void mazeGui::mouseMoveEvent(QGraphicsSceneMouseEvent *mouseEvent)
+{
+    if(_drag == DRAG_RECT)
+    {
+        QPoint end = this->cellAt(mouseEvent->scenePos());
+        QRect cells = QRect(_rectStart, end).normalized();
+        _selection->setRect(cells.x()*PX_PER_UNIT, cells.y()*PX_PER_UNIT, cells.width()*PX_PER_UNIT, cells.height()*PX_PER_UNIT);
+        return;
+    }
+    QPoint cell;
+    Wall wall;
+    if(_drag != DRAG_STROKE || !this->edgeAt(mouseEvent->scenePos(), cell, wall) || (cell == _lastCell && wall == _lastWall))
+    {
+        return;
+    }
+    _lastCell = cell;
+    _lastWall = wall;
+    emit editWall(cell, wall, _dragWall);
+}
+
+void mazeGui::mouseReleaseEvent(QGraphicsSceneMouseEvent *mouseEvent)
+{
+    if(_drag == DRAG_RECT)
+    {
+        QRect cells = QRect(_rectStart, this->cellAt(mouseEvent->scenePos())).normalized();
+        delete _selection;
+        _selection = NULL;
+        _drag = DRAG_NONE;
+        emit editRect(cells, _dragWall);
+    }
+    else if(_drag == DRAG_STROKE)
+    {
+        _drag = DRAG_NONE;
+        emit strokeFinished();
     }
 }
 
@@ -122,84 +149,155 @@ QPen mazeGui::wallPen()
 
 void mazeGui::drawGuideLines()
 {
-    this->_bgGrid = this->createItemGroup(this->selectedItems());
-    for(int i = 0 ; i <= MAZE_WIDTH; i++)
+    qDeleteAll(this->_bgGrid->childItems());
+    for(int i = 0 ; i <= _width; i++)
     {
-       this->_bgGrid->addToGroup(this->addLine(i*PX_PER_UNIT,0,i*PX_PER_UNIT,MAZE_WIDTH_PX,*this->_guidePen));
+       this->_bgGrid->addToGroup(this->addLine(i*PX_PER_UNIT,0,i*PX_PER_UNIT,_height*PX_PER_UNIT,*this->_guidePen));
     }
-    for(int i = 0; i <= MAZE_HEIGHT; i++)
+    for(int i = 0; i <= _height; i++)
     {
-       this->_bgGrid->addToGroup(this->addLine(0,i*PX_PER_UNIT,MAZE_HEIGHT_PX,i*PX_PER_UNIT, *this->_guidePen));
+       this->_bgGrid->addToGroup(this->addLine(0,i*PX_PER_UNIT,_width*PX_PER_UNIT,i*PX_PER_UNIT, *this->_guidePen));
     }
 }
 
-void mazeGui::drawMaze(baseMapNode data[][MAZE_HEIGHT])
+void mazeGui::setMazeSize(int width, int height)
 {
-    //delete old maze walls from GUI
-    this->removeItem(this->mazeWalls);
-    while (this->mazeWalls->childItems().size()>0)
+    if(width == _width && height == _height)
     {
-       //this is super inefficient, causes noticeable lag when changing maze
-       delete (this->mazeWalls->childItems().first());
+        return;
     }
-    this->addItem(this->mazeWalls);
+    _width = width;
+    _height = height;
+    this->setSceneRect(QRectF(QPoint(0,0), QPoint(_width*PX_PER_UNIT,_height*PX_PER_UNIT)));
+    this->drawGuideLines();
+    this->resetWalls();
+}
+
+//throws away every wall item, only needed when the maze size changes
+void mazeGui::resetWalls()
+{
+    qDeleteAll(_vItems);
+    qDeleteAll(_hItems);
+    _vItems.assign((size_t)(_width-1)*_height, NULL);
+    _hItems.assign((size_t)_width*(_height-1), NULL);
+    _drawnV.assign(baseMap::vWords(_width, _height), 0);
+    _drawnH.assign(baseMap::hWords(_width, _height), 0);
 
-    //Draw maze walls
-    for(int i = 0; i < MAZE_WIDTH; i++)
+    //the outside is always a wall, one item for all four sides
+    delete _border;
+    _border = new QGraphicsRectItem(0, 0, _width*PX_PER_UNIT, _height*PX_PER_UNIT);
+    _border->setPen(*_wallPen);
+    this->mazeWalls->addToGroup(_border);
+}
+
+void mazeGui::showEdge(bool vertical, size_t edge, bool isWall)
+{
+    std::vector<QGraphicsLineItem *> &items = vertical ? _vItems : _hItems;
+    if(!items[edge])
     {
-        for(int j = 0; j < MAZE_HEIGHT; j++)
+        if(!isWall)
         {
-            baseMapNode *mover = &data[i][j];
-            if(mover->isWallBottom())
-            {
-                this->mazeWalls->addToGroup(this->addLine(QLineF(i*PX_PER_UNIT,j*PX_PER_UNIT,(i+1)*PX_PER_UNIT,j*PX_PER_UNIT),*_wallPen));
-            }
-            if(mover->isWallTop())
-            {
-                this->mazeWalls->addToGroup(this->addLine(QLineF(i*PX_PER_UNIT,(j+1)*PX_PER_UNIT,(i+1)*PX_PER_UNIT,(j+1)*PX_PER_UNIT),*_wallPen));
-            }
-            if(mover->isWallLeft())
-            {
-                this->mazeWalls->addToGroup(this->addLine(QLineF(i*PX_PER_UNIT,j*PX_PER_UNIT, i*PX_PER_UNIT,(j+1)*PX_PER_UNIT),*_wallPen));
-            }
-            if(mover->isWallRight())
+            return;
+        }
+        //v edge is the wall right of (x,y), h edge is the wall above it
+        int x, y;
+        QLineF line;
+        if(vertical)
+        {
+            x = edge % (_width-1);
+            y = edge / (_width-1);
+            line = QLineF((x+1)*PX_PER_UNIT, y*PX_PER_UNIT, (x+1)*PX_PER_UNIT, (y+1)*PX_PER_UNIT);
+        }
+        else
+        {
+            x = edge % _width;
+            y = edge / _width;
+            line = QLineF(x*PX_PER_UNIT, (y+1)*PX_PER_UNIT, (x+1)*PX_PER_UNIT, (y+1)*PX_PER_UNIT);
+        }
+        items[edge] = new QGraphicsLineItem(line);
+        items[edge]->setPen(*_wallPen);
+        this->mazeWalls->addToGroup(items[edge]);
+    }
+    items[edge]->setVisible(isWall);
+}
+
+void mazeGui::drawMaze(const baseMap &data)
+{
+    this->setMazeSize(data.width(), data.height());
+
+    if(_vItems.size() != (size_t)(_width-1)*_height || !_border)
+    {
+        this->resetWalls();
+    }
+
+    //only walk the bits that differ from what is on screen
+    const uint64_t *words[2] = {data.wordsV(), data.wordsH()};
+    std::vector<uint64_t> *drawn[2] = {&_drawnV, &_drawnH};
+    size_t edges[2] = {_vItems.size(), _hItems.size()};
+    for(int side = 0; side < 2; side++)
+    {
+        std::vector<uint64_t> &shown = *drawn[side];
+        for(size_t w = 0; w < shown.size(); w++)
+        {
+            uint64_t changed = words[side][w] ^ shown[w];
+            while(changed)
             {
-                this->mazeWalls->addToGroup(this->addLine(QLineF((i+1)*PX_PER_UNIT,j*PX_PER_UNIT,(i+1)*PX_PER_UNIT,(j+1)*PX_PER_UNIT),*_wallPen));
+                size_t edge = w*64 + qCountTrailingZeroBits((quint64)changed);
+                changed &= changed - 1;
+                if(edge < edges[side])
+                {
+                    this->showEdge(side == 0, edge, (words[side][w] >> (edge & 63)) & 1);
+                }
             }
+            shown[w] = words[side][w];
         }
     }
     drawMouse(_mousePos, _mouseDir);
 }
 
-void mazeGui::drawMouse(QPoint cell, mDirection direction)
+//redraws the one wall an editor click changed, outside walls never change
+void mazeGui::drawWall(const baseMap &data, int x, int y, Wall pos)
 {
-    _mouseDir = direction;
-    _mousePos = cell;
-    //math!
-    float xPos = (cell.x()-1) * PX_PER_UNIT + PX_PER_UNIT *.125;
-    float yPos = (cell.y()-1) * PX_PER_UNIT + PX_PER_UNIT *.125;
-    QRectF boundingBox(xPos,
-                       yPos,
-                       PX_PER_UNIT * .75,
-                       PX_PER_UNIT * .75);
-
-    int startAngle = (45 + 90*direction)*16, spanAngle = (360-90)*16;
-    QGraphicsEllipseItem *delHolder = _mouse;
-    _mouse = this->addEllipse(boundingBox, *_mousePen, *_mouseBrush);
-    _mouse->setStartAngle(startAngle);
-    _mouse->setSpanAngle(spanAngle);
-    if(delHolder) delete delHolder;
-}
+    if(!_border || data.width() != _width || data.height() != _height || x < 0 || y < 0 || x >= _width || y >= _height)
+    {
+        this->drawMaze(data);
+        return;
+    }
 
-int mazeGui::mouseX()
-{
-   return _mousePos.x();
-}
-int mazeGui::mouseY()
-{
-    return _mousePos.y();
+    bool vertical = pos == LEFT || pos == RIGHT;
+    if(pos == LEFT) x--;
+    if(pos == BOTTOM) y--;
+    if(x < 0 || y < 0 || (vertical && x >= _width-1) || (!vertical && y >= _height-1))
+    {
+        return;
+    }
+
+    size_t edge = vertical ? (size_t)y*(_width-1) + x : (size_t)y*_width + x;
+    bool isWall = vertical ? data.isWallRight(x, y) : data.isWallTop(x, y);
+    uint64_t &shown = vertical ? _drawnV[edge >> 6] : _drawnH[edge >> 6];
+    uint64_t mask = (uint64_t)1 << (edge & 63);
+    shown = isWall ? shown | mask : shown & ~mask;
+    this->showEdge(vertical, edge, isWall);
 }
-mDirection mazeGui::mouseDir()
+
+//the mouse is one item for the whole session, moving or turning it is just a new transform
+void mazeGui::drawMouse(QPoint cell, mDirection direction)
 {
-    return _mouseDir;
+    if(!_mouse)
+    {
+        //drawn around its own origin facing right, the gap is the front of the mouse
+        float radius = PX_PER_UNIT * .375;
+        _mouse = this->addEllipse(QRectF(-radius, -radius, 2*radius, 2*radius), *_mousePen, *_mouseBrush);
+        _mouse->setStartAngle(45*16);
+        _mouse->setSpanAngle((360-90)*16);
+        _mousePos = QPoint(0, 0);
+    }
+    if(cell != _mousePos)
+    {
+        _mousePos = cell;
+        _mouse->setPos((cell.x()-.5) * PX_PER_UNIT, (cell.y()-.5) * PX_PER_UNIT);
+    }
+    //angles go counter clockwise, rotation goes clockwise
+    _mouseDir = direction;
+    _mouse->setRotation(-90*direction);
 }
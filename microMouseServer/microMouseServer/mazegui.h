@@ -8,7 +8,9 @@
 #include <QGraphicsItem>
 #include <QPainter>
 #include <QPoint>
+#include <QRect>
 #include <QStyleOptionGraphicsItem>
+#include <vector>
 
 class mazeGui : public QGraphicsScene
 {
@@ -17,34 +19,38 @@ public:
     explicit mazeGui(QObject *parent = 0);
     ~mazeGui();
     virtual void mousePressEvent(QGraphicsSceneMouseEvent * mouseEvent);
+    virtual void mouseMoveEvent(QGraphicsSceneMouseEvent * mouseEvent);
+    virtual void mouseReleaseEvent(QGraphicsSceneMouseEvent * mouseEvent);
     QPen wallPen();
 
     QGraphicsItemGroup *mazeWalls;
 
-    void drawMaze(baseMapNode data[][MAZE_HEIGHT]);
+    void drawMaze(const baseMap &data);
+    void drawWall(const baseMap &data, int x, int y, Wall pos);
     void drawMouse(QPoint cell, mDirection direction);
     void drawGuideLines();
-
-    int mouseX();
-    int mouseY();
-    void setMouseX();
-    void setMouseY();
-    mDirection mouseDir();
+    void setMazeSize(int width, int height);
 
 signals:
-    void passRightWall(QPoint cell);
-    void passLeftWall(QPoint cell);
-    void passTopWall(QPoint cell);
-    void passBottomWall(QPoint cell);
-    void takeRightWall(QPoint cell);
-    void takeLeftWall(QPoint cell);
-    void takeTopWall(QPoint cell);
-    void takeBottomWall(QPoint cell);
+    //a drag with the left button adds every wall it passes, the right button takes
+    //them away. Everything between strokeStarted() and strokeFinished() is one edit
+    void strokeStarted();
+    void editWall(QPoint cell, Wall pos, bool isWall);
+    void strokeFinished();
+    //shift and drag: every wall of the cells in the rectangle, or none between them
+    void editRect(QRect cells, bool isWall);
 
 
 public slots:
 
 private:
+    enum dragMode { DRAG_NONE, DRAG_STROKE, DRAG_RECT };
+
+    bool edgeAt(QPointF pos, QPoint &cell, Wall &wall);
+    QPoint cellAt(QPointF pos);
+    void resetWalls();
+    void showEdge(bool vertical, size_t edge, bool isWall);
+
     QGraphicsItemGroup *_bgGrid;
     QGraphicsEllipseItem *_mouse;
     QPen *_wallPen;
@@ -53,6 +59,21 @@ private:
     QBrush *_mouseBrush;
     QPoint _mousePos;
     mDirection _mouseDir;
+    int _width, _height;
+
+    dragMode _drag;
+    bool _dragWall;                 //adding walls, not taking them away
+    QPoint _lastCell;               //the wall the stroke passed last
+    Wall _lastWall;
+    QPoint _rectStart;
+    QGraphicsRectItem *_selection;
+
+    //one line item per wall, indexed like the baseMap v/h bits and only created
+    //the first time that wall shows up. _drawnV/_drawnH are the words currently
+    //on screen so drawMaze only has to touch the walls that changed
+    QGraphicsRectItem *_border;
+    std::vector<QGraphicsLineItem *> _vItems, _hItems;
+    std::vector<uint64_t> _drawnV, _drawnH;
 };
 
 #endif // MAZEGUI_H
@@ -12,16 +12,14 @@ TARGET = microMouseServer
 TEMPLATE = app
 
 
+include(simCore.pri)
+
 SOURCES += mazegui.cpp\
         main.cpp \
-        micromouseserver.cpp \
-    mazeBase.cpp \
-    studentai.cpp
+        micromouseserver.cpp
 
 
 HEADERS  += micromouseserver.h \
-    mazeConst.h \
-    mazeBase.h \
     mazegui.h
 
 FORMS    += micromouseserver.ui
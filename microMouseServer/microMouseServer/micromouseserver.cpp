@@ -2,19 +2,39 @@
 #include "ui_micromouseserver.h"
 #include "mazeConst.h"
 #include "mazegui.h"
+#include "mazeIO.h"
+#include "mazeGenerator.h"
 #include <QFileDialog>
 #include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
+#include <QInputDialog>
+#include <QDateTime>
 
+//cmb_runSpeed entries as multiples of real time, 0 is unthrottled
+static const double runSpeeds[] = {1, 2, 4, 10, 100, 0};
 
 microMouseServer::microMouseServer(QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::microMouseServer)
 {
     maze = new mazeGui;
+    _sim = new mazeSim;
+    _runner = new simRunner(_sim);
+    _runner->setRobot(&_robot);
     _comTimer = new QTimer(this);
-    _aiCallTimer = new QTimer(this);
+    _frameTimer = new QTimer(this);
+    _replayTimer = new QTimer(this);
+    _replayPos = 0;
+    _replayState = _trace.startState();
+    _sim->setTrace(&_trace);
+    _sim->setTiming(true);
+    _mazeName = "blank";
+    _robotSpec = "tcp:127.0.0.1:4700";
+    _solverIndex = 0;
+    _editor.setMaze(&_sim->mazeData);
     ui->setupUi(this);
+    _solverGroup = new QActionGroup(this);
+    this->listSolvers();
     connectSignals();
 
     ui->graphics->scale(1,-1);
@@ -22,18 +42,20 @@ microMouseServer::microMouseServer(QWidget *parent) :
     ui->graphics->setAutoFillBackground(true);
     ui->graphics->setScene(maze);
 
-    this->initMaze();
     this->maze->drawGuideLines();
-    this->maze->drawMaze(this->mazeData);
+    this->maze->drawMaze(_sim->mazeData);
+    this->showEditMenu();
 
 }
 
 
 microMouseServer::~microMouseServer()
 {
+    delete _runner;
     delete ui;
     delete _comTimer;
     delete maze;
+    delete _sim;
 }
 
 
@@ -49,457 +71,566 @@ void microMouseServer::connectSignals()
 
     connect(ui->menu_loadMaze, SIGNAL(triggered()), this, SLOT(loadMaze()));
     connect(ui->menu_saveMaze, SIGNAL(triggered()), this, SLOT(saveMaze()));
+    connect(ui->menu_generateMaze, SIGNAL(triggered()), this, SLOT(generateMaze()));
     connect(ui->menu_connect2Mouse, SIGNAL(triggered()), this, SLOT(connect2mouse()));
     connect(ui->menu_startRun, SIGNAL(triggered()), this, SLOT(startAI()));
+    connect(ui->menu_turboRun, SIGNAL(triggered()), this, SLOT(turboAI()));
 
     connect(_comTimer, SIGNAL(timeout()), this, SLOT(netComs()));
-    connect(_aiCallTimer, SIGNAL(timeout()), this, SLOT(studentAI()));
-
-    connect(this->maze, SIGNAL(passTopWall(QPoint)), this, SLOT(addTopWall(QPoint)));
-    connect(this->maze, SIGNAL(passBottomWall(QPoint)), this, SLOT(addBottomWall(QPoint)));
-    connect(this->maze, SIGNAL(passLeftWall(QPoint)), this, SLOT(addLeftWall(QPoint)));
-    connect(this->maze, SIGNAL(passRightWall(QPoint)), this, SLOT(addRightWall(QPoint)));
-    connect(this->maze, SIGNAL(takeBottomWall(QPoint)),this,SLOT(removeBottomWall(QPoint)));
-    connect(this->maze, SIGNAL(takeTopWall(QPoint)),this,SLOT(removeTopWall(QPoint)));
-    connect(this->maze, SIGNAL(takeLeftWall(QPoint)),this,SLOT(removeLeftWall(QPoint)));
-    connect(this->maze, SIGNAL(takeRightWall(QPoint)),this,SLOT(removeRightWall(QPoint)));
+    connect(ui->cmb_runSpeed, SIGNAL(currentIndexChanged(int)), this, SLOT(changeRunSpeed(int)));
+    connect(_frameTimer, SIGNAL(timeout()), this, SLOT(drawFrame()));
+    connect(ui->menu_replayTrace, SIGNAL(triggered()), this, SLOT(replayTrace()));
+    connect(ui->menu_loadTrace, SIGNAL(triggered()), this, SLOT(loadTrace()));
+    connect(ui->menu_saveTrace, SIGNAL(triggered()), this, SLOT(saveTrace()));
+    connect(ui->menu_statsFile, SIGNAL(triggered()), this, SLOT(chooseStatsFile()));
+    connect(ui->menu_loadPlugin, SIGNAL(triggered()), this, SLOT(loadPlugin()));
+    connect(ui->menu_reloadPlugins, SIGNAL(triggered()), this, SLOT(reloadPlugins()));
+    connect(_solverGroup, SIGNAL(triggered(QAction*)), this, SLOT(chooseSolver(QAction*)));
+    connect(_replayTimer, SIGNAL(timeout()), this, SLOT(replayStep()));
+    connect(ui->sld_replay, SIGNAL(valueChanged(int)), this, SLOT(scrubTrace(int)));
+
+    connect(this->maze, SIGNAL(strokeStarted()), this, SLOT(startStroke()));
+    connect(this->maze, SIGNAL(editWall(QPoint,Wall,bool)), this, SLOT(editWall(QPoint,Wall,bool)));
+    connect(this->maze, SIGNAL(strokeFinished()), this, SLOT(finishStroke()));
+    connect(this->maze, SIGNAL(editRect(QRect,bool)), this, SLOT(editRect(QRect,bool)));
+    connect(ui->menu_undo, SIGNAL(triggered()), this, SLOT(undoEdit()));
+    connect(ui->menu_redo, SIGNAL(triggered()), this, SLOT(redoEdit()));
+    connect(ui->menu_mirrorLeftRight, SIGNAL(triggered()), this, SLOT(mirrorLeftRight()));
+    connect(ui->menu_mirrorTopBottom, SIGNAL(triggered()), this, SLOT(mirrorTopBottom()));
+    connect(ui->menu_rotateRight, SIGNAL(triggered()), this, SLOT(rotateRight()));
+    connect(ui->menu_rotateLeft, SIGNAL(triggered()), this, SLOT(rotateLeft()));
+    connect(ui->menu_rotate180, SIGNAL(triggered()), this, SLOT(rotate180()));
 }
+//asks for the link to the mouse, a second click disconnects. mouseEmu can stand in for it
 void microMouseServer::connect2mouse()
 {
-    //cut for mac compatibility
+    if(_robot.isOpen())
+    {
+        this->stopRuns();
+        _comTimer->stop();
+        _sim->setRobot(NULL);
+        _robot.close();
+        ui->txt_debug->append("Disconnected from the mouse.");
+        return;
+    }
+
+    bool ok;
+    QString spec = QInputDialog::getText(this, tr("Connect to Mouse"),
+             tr("tcp:host:port, udp:host:port or serial:/dev/tty...[:baud]"), QLineEdit::Normal, _robotSpec, &ok);
+    if(!ok || spec.isEmpty())
+    {
+        return;
+    }
+    _robotSpec = spec;
+    mazeError err = _robot.open(spec.toUtf8().constData());
+    if(err != MAZE_OK)
+    {
+        ui->txt_debug->append(mazeErrorString(err));
+        return;
+    }
+    this->stopRuns();
+    _sim->setRobot(&_robot);
+    _comTimer->start(1000);
+    ui->txt_debug->append("Connected to the mouse on " + spec + ", load the maze it is in to watch it.");
 }
 
+//pings an idle link so the round trip stays current, a run times every exchange anyway
+//and owns the link until it stops
 void microMouseServer::netComs()
 {
-    //cut for mac compatibility
+    if(!_robot.isOpen())
+    {
+        _comTimer->stop();
+        return;
+    }
+    if(!_runner->isRunning() && !_robot.ping())
+    {
+        _comTimer->stop();
+        _sim->setRobot(NULL);
+        _robot.close();
+        ui->txt_debug->append("Lost the link to the mouse.");
+        return;
+    }
+    this->showStats();
 }
 
 void microMouseServer::loadMaze()
 {
     //open file find window
     QString fileName = QFileDialog::getOpenFileName(this,
-             tr("Open Maze File"), "./", tr("Maze Files (*.maz)"));
-    QFile inFile(fileName);
-
-    //if the file can't be opened throw error to ui
-    if (!inFile.open(QIODevice::ReadOnly | QIODevice::Text))
-    {
-        ui->txt_debug->append("ERROR 202: file not found");
-        return;
-    }
-
-    //read maze
-    QTextStream mazeFile(&inFile);
-
-    int largestX =0, largestY=0;
-    int x, y, wallTop, wallBottom, wallLeft,wallRight;
-    while(!mazeFile.atEnd())
+             tr("Open Maze File"), "./", tr("Maze Files (*.maz *.mazb)"));
+
+    //read maze into a scratch map so a bad file leaves the current maze alone,
+    //the maze size comes from the file. .mazb files are mapped, not copied
+    baseMap loaded;
+    int errorLine;
+    mazeError err = readMaze(QFile::encodeName(fileName).constData(), loaded, &errorLine);
+    if(err != MAZE_OK)
     {
-        mazeFile >> x;
-        mazeFile >> y;
-        mazeFile >> wallTop;
-        mazeFile >> wallBottom;
-        mazeFile >> wallLeft;
-        mazeFile >> wallRight;
-
-        //check formating
-        if(x<0 || y<0 || wallTop<0 || wallBottom<0 || wallLeft<0 || wallRight<0 ||
-           wallTop>1 || wallBottom>1 || wallLeft>1 || wallRight>1)
-        {
-            ui->txt_debug->append("ERROR 201: file formating error");
-            return;
-        }
-
-        //check x boundary
-        if(x > largestX)
-        {
-            if(x > MAZE_WIDTH)
-            {
-                ui->txt_debug->append("ERROR 204: maze file is wider than max maze size");
-            }
-            else
-            {
-                largestX = x;
-            }
-        }
-
-        //check y boundary
-        if(y > largestY)
-        {
-            if(y > MAZE_HEIGHT)
-            {
-                ui->txt_debug->append("ERROR 205: maze file is taller than max maze size");
-            }
-            else
-            {
-                largestY = y;
-            }
-        }
-
-        baseMapNode *mover = &this->mazeData[x-1][y-1];
-        //load data into maze
-        mover->setXY(x,y);
-
-        if(wallLeft)
+        QString mesg = mazeErrorString(err);
+        if(errorLine)
         {
-             mover->setWall(LEFT, NULL);
-        }
-        else
-        {
-            //mover->setWall(LEFT, &this->mazeData[x-1][y]);
-        }
-
-        if(wallRight)
-        {
-            mover->setWall(RIGHT, NULL);
-        }
-        else
-        {
-            //mover->setWall(RIGHT, &this->mazeData[x+1][y]);
-        }
-        if(wallTop)
-        {
-            mover->setWall(TOP, NULL);
-        }
-        else
-        {
-            //mover->setWall(TOP, &this->mazeData[x][y+1]);
-        }
-
-        if(wallBottom)
-        {
-            mover->setWall(BOTTOM, NULL);
-        }
-        else
-        {
-            //mover->setWall(BOTTOM, &this->mazeData[x][y-1]);
+            mesg += QString(" (line %1)").arg(errorLine);
         }
+        ui->txt_debug->append(mesg);
+        return;
     }
+    this->stopRuns();
+    _sim->mazeData = loaded;
+    _editor.forget();
+    this->showEditMenu();
+    _mazeName = QFileInfo(fileName).fileName();
     ui->txt_debug->append("Maze loaded");
-    mazeFile.flush();
-    inFile.close();
 
     //draw maze and mouse
-    this->maze->drawMaze(this->mazeData);
-    this->maze->drawMouse(QPoint(1,1),dUP);
+    _sim->mazeChanged();
+    _sim->resetMouse();
+    this->maze->drawMaze(_sim->mazeData);
+    this->maze->drawMouse(QPoint(_sim->mouseX(),_sim->mouseY()),_sim->mouseDir());
 }
 
 
 void microMouseServer::saveMaze()
 {
     //open file save window
+    QString binaryFilter = tr("Binary Maze Files (*.mazb)");
+    QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(this,
-             tr("Select Maze File"), "", tr("Maze Files (*.maz)"));
-    QFile inFile(fileName);
-
-    //if file can't be opened throw error to UI
-    if (!inFile.open(QIODevice::WriteOnly | QIODevice::Text))
+             tr("Select Maze File"), "", tr("Maze Files (*.maz)") + ";;" + binaryFilter, &selectedFilter);
+    if(fileName.isEmpty())
     {
-        ui->txt_debug->append("ERROR 202: file not found");
         return;
     }
-    else
+    if(selectedFilter == binaryFilter && !fileName.endsWith(".mazb"))
     {
-        QTextStream mazeFile(&inFile);
+        fileName += ".mazb";
+    }
 
-        for(int i = 0; i < MAZE_WIDTH; i++)
-        {
-            for(int j = 0; j < MAZE_HEIGHT; j++)
-            {
-                int top = this->mazeData[i][j].isWallTop();
-                int bottom = this->mazeData[i][j].isWallBottom();
-                int left = this->mazeData[i][j].isWallLeft();
-                int right = this->mazeData[i][j].isWallRight();
-
-                mazeFile << this->mazeData[i][j].posX() << " " << this->mazeData[i][j].posY() << " " << top << " " << bottom << " " << left << " " << right << endl;
-            }
-        }
+    //the extension picks the format, anything but .mazb is written as text
+    mazeError err = writeMaze(QFile::encodeName(fileName).constData(), _sim->mazeData);
+    if(err != MAZE_OK)
+    {
+        ui->txt_debug->append(mazeErrorString(err));
+        return;
+    }
+    ui->txt_debug->append("Maze Saved to File.");
+}
 
-        mazeFile.flush();
+//new random maze the size of the current one, the seed is printed so a good one can be made again with mazeGen
+void microMouseServer::generateMaze()
+{
+    this->stopRuns();
+    mazeGenOptions options;
+    options.width = _sim->mazeData.width();
+    options.height = _sim->mazeData.height();
+    options.braid = 0.1;
+    options.seed = QDateTime::currentMSecsSinceEpoch();
+    mazeGenerator generator(options);
+    generator.generate(0, _sim->mazeData);
+    _editor.forget();
+    this->showEditMenu();
+    ui->txt_debug->append(QString("Maze generated, seed %1").arg(options.seed));
+    _mazeName = QString("seed %1").arg(options.seed);
+
+    _sim->mazeChanged();
+    _sim->resetMouse();
+    this->maze->drawMaze(_sim->mazeData);
+    this->maze->drawMouse(QPoint(_sim->mouseX(),_sim->mouseY()),_sim->mouseDir());
+}
 
-        inFile.close();
-        ui->txt_debug->append("Maze Saved to File.");
-    }
+//A stroke's walls are drawn one by one as the pointer passes them and go into
+//the history as one edit. An edit ends any run, the worker may be reading the walls
+void microMouseServer::startStroke()
+{
+    this->stopRuns();
+    _editor.begin();
 }
 
-void microMouseServer::initMaze()
+void microMouseServer::editWall(QPoint cell, Wall pos, bool isWall)
 {
-    //zero out data in maze, way slower than memset but safer. Will switch to memset if I have time to test
-    for(int y =0; y < MAZE_HEIGHT; y++)
-    {
-        for(int x = 0; x < MAZE_WIDTH; x++)
-        {
-            baseMapNode *mover = &this->mazeData[x][y];
-            mover->setXY(x+1,y+1);
-            if(x == 0)
-            {
-                mover->setWall(LEFT, NULL);
-            }
-            else
-            {
-                mover->setWall(LEFT, &this->mazeData[x-1][y]);
-            }
-            if(x == MAZE_WIDTH-1)
-            {
-                mover->setWall(RIGHT, NULL);
-            }
-            else
-            {
-                mover->setWall(RIGHT, &this->mazeData[x+1][y]);
-            }
-            if(y == 0)
-            {
-                mover->setWall(BOTTOM, NULL);
-            }
-            else
-            {
-                mover->setWall(BOTTOM,  &this->mazeData[x][y-1]);
-            }
-            if(y == MAZE_HEIGHT-1)
-            {
-                mover->setWall(TOP, NULL);
-            }
-            else
-            {
-                mover->setWall(TOP,  &this->mazeData[x][y+1]);
-            }
-        }
-    }
+    _editor.setWall(cell.x(), cell.y(), pos, isWall);
+    this->maze->drawWall(_sim->mazeData, cell.x(), cell.y(), pos);
 }
 
+void microMouseServer::finishStroke()
+{
+    _editor.end();
+    this->showEditMenu();
+}
 
-//--This is a terrible way of doing this in C++, I will fix in the next revision
-void microMouseServer::removeRightWall(QPoint cell)
+//the bulk edits change any number of walls, then the view catches up in one drawMaze
+void microMouseServer::editRect(QRect cells, bool isWall)
 {
-    if(cell.x() < MAZE_WIDTH -1)
+    this->stopRuns();
+    bool changed = isWall ? _editor.fillRect(cells.left(), cells.top(), cells.right(), cells.bottom())
+                          : _editor.clearRect(cells.left(), cells.top(), cells.right(), cells.bottom());
+    if(changed)
     {
-        this->mazeData[cell.x()][cell.y()].setWall(RIGHT, &this->mazeData[cell.x()+1][cell.y()]);
-        this->mazeData[cell.x()+1][cell.y()].setWall(LEFT, &this->mazeData[cell.x()][cell.y()]);
+        this->maze->drawMaze(_sim->mazeData);
+        this->showEditMenu();
     }
-    this->maze->drawMaze(this->mazeData);
 }
 
-void microMouseServer::removeLeftWall(QPoint cell)
+void microMouseServer::undoEdit()
 {
-    if(cell.x() > 0)
+    this->stopRuns();
+    if(_editor.undo())
     {
-        this->mazeData[cell.x()][cell.y()].setWall(LEFT, &this->mazeData[cell.x()-1][cell.y()]);
-        this->mazeData[cell.x()-1][cell.y()].setWall(RIGHT, &this->mazeData[cell.x()][cell.y()]);
+        this->maze->drawMaze(_sim->mazeData);
+        this->showEditMenu();
     }
-    this->maze->drawMaze(this->mazeData);
 }
 
-void microMouseServer::removeTopWall(QPoint cell)
+void microMouseServer::redoEdit()
 {
-    if(cell.y() < MAZE_HEIGHT -1)
+    this->stopRuns();
+    if(_editor.redo())
     {
-        this->mazeData[cell.x()][cell.y()].setWall(TOP, &this->mazeData[cell.x()][cell.y()+1]);
-        this->mazeData[cell.x()][cell.y()+1].setWall(BOTTOM, &this->mazeData[cell.x()][cell.y()]);
+        this->maze->drawMaze(_sim->mazeData);
+        this->showEditMenu();
     }
-    this->maze->drawMaze(this->mazeData);
 }
 
-void microMouseServer::removeBottomWall(QPoint cell)
+void microMouseServer::transformMaze(mazeTransform how)
 {
-    if(cell.y() > 0)
+    this->stopRuns();
+    if(!_editor.transform(how))
     {
-        this->mazeData[cell.x()][cell.y()].setWall(BOTTOM, &this->mazeData[cell.x()][cell.y()-1]);
-        this->mazeData[cell.x()][cell.y()-1].setWall(TOP, &this->mazeData[cell.x()][cell.y()]);
+        ui->txt_debug->append("Only a square maze can be turned a quarter of the way round.");
+        return;
     }
-    this->maze->drawMaze(this->mazeData);
+    this->maze->drawMaze(_sim->mazeData);
+    this->showEditMenu();
+}
+
+void microMouseServer::mirrorLeftRight()
+{
+    this->transformMaze(MIRROR_LEFT_RIGHT);
+}
+
+void microMouseServer::mirrorTopBottom()
+{
+    this->transformMaze(MIRROR_TOP_BOTTOM);
 }
 
-void microMouseServer::addLeftWall(QPoint cell)
+void microMouseServer::rotateRight()
 {
-    this->mazeData[cell.x()][cell.y()].setWall(LEFT, NULL);
-    if(cell.x() > 0)this->mazeData[cell.x()-1][cell.y()].setWall(RIGHT,NULL);
-    this->maze->drawMaze(this->mazeData);
+    this->transformMaze(ROTATE_RIGHT);
 }
 
-void microMouseServer::addRightWall(QPoint cell)
+void microMouseServer::rotateLeft()
 {
-    this->mazeData[cell.x()][cell.y()].setWall(RIGHT, NULL);
-    if(cell.x() < MAZE_WIDTH )this->mazeData[cell.x()+1][cell.y()].setWall(LEFT, NULL);
-    this->maze->drawMaze(this->mazeData);
+    this->transformMaze(ROTATE_LEFT);
 }
 
-void microMouseServer::addTopWall(QPoint cell)
+void microMouseServer::rotate180()
 {
-    this->mazeData[cell.x()][cell.y()].setWall(TOP, NULL);
-    if(cell.y() < MAZE_HEIGHT)this->mazeData[cell.x()][cell.y()+1].setWall(BOTTOM,NULL);
-    this->maze->drawMaze(this->mazeData);
+    this->transformMaze(ROTATE_180);
 }
 
-void microMouseServer::addBottomWall(QPoint cell)
+void microMouseServer::showEditMenu()
 {
-    this->mazeData[cell.x()][cell.y()].setWall(BOTTOM, NULL);
-    if(cell.y() > 0)this->mazeData[cell.x()][cell.y()-1].setWall(TOP,NULL);
-    this->maze->drawMaze(this->mazeData);
+    ui->menu_undo->setEnabled(_editor.canUndo());
+    ui->menu_redo->setEnabled(_editor.canRedo());
 }
 //--up to here
 
+//ticks the AI at the speed picked in cmb_runSpeed on the runner's thread
 void microMouseServer::startAI()
 {
-    QPoint newPos;
-    newPos.setX(1);
-    newPos.setY(1);
-    this->maze->drawMouse(newPos, dUP);
-    _aiCallTimer->start(MDELAY);
+    this->stopRuns();
+    _sim->resetMouse();
+    _runner->start(runSpeeds[ui->cmb_runSpeed->currentIndex()]);
+    this->drawFrame();
+    _frameTimer->start(1000/FRAME_RATE);
+}
+
+//runs the AI as fast as it goes, the view still only redraws at FRAME_RATE
+void microMouseServer::turboAI()
+{
+    ui->cmb_runSpeed->setCurrentIndex(ui->cmb_runSpeed->count() - 1);
+    this->startAI();
+}
+
+//a run already going carries on at the new speed
+void microMouseServer::changeRunSpeed(int index)
+{
+    _runner->setSpeed(runSpeeds[index]);
+}
+
+//takes in what the runner did since the last frame, the finish included
+void microMouseServer::drawFrame()
+{
+    _runner->poll(this);
+    this->maze->drawMouse(QPoint(_runner->mouseX(),_runner->mouseY()), _runner->mouseDir());
+    this->showStats();
+}
+
+//the runner's copies while it runs, the sim and link are the worker's until then
+void microMouseServer::showStats()
+{
+    bool running = _runner->isRunning();
+    QString text = QString::fromStdString((running ? _runner->stats() : _sim->stats()).summary());
+    if(_robot.isOpen())
+    {
+        simLinkStats link = _runner->linkStats();
+        if(!running)
+        {
+            link.lastRtt = _robot.lastRtt();
+            link.averageRtt = _robot.averageRtt();
+            link.maxRtt = _robot.maxRtt();
+            link.roundTrips = _robot.roundTrips();
+        }
+        text += QString("\nmouse link: %1 us last, %2 us average, %3 us max over %4 round trips\n")
+                .arg(link.lastRtt, 0, 'f', 0).arg(link.averageRtt, 0, 'f', 0)
+                .arg(link.maxRtt, 0, 'f', 0).arg(link.roundTrips);
+    }
+    ui->txt_stats->setPlainText(text);
 }
 
-void microMouseServer::foundFinish()
+//called from drawFrame() once the runner's thread is done with the sim
+void microMouseServer::simFinished()
 {
-    _aiCallTimer->stop();
+    _frameTimer->stop();
+    this->maze->drawMouse(QPoint(_sim->mouseX(),_sim->mouseY()), _sim->mouseDir());
+    this->showStats();
     ui->txt_status->append("Found end of maze.");
+    if(!_statsFile.isEmpty())
+    {
+        mazeError err = saveRunStats(QFile::encodeName(_statsFile).constData(), _mazeName.toUtf8().constData(), _sim->stats());
+        if(err != MAZE_OK)
+        {
+            ui->txt_debug->append(mazeErrorString(err));
+        }
+    }
 }
 
-void microMouseServer::printUI(const char *mesg)
+//.csv collects a row per run, .json keeps the last run
+void microMouseServer::chooseStatsFile()
 {
-    ui->txt_status->append(mesg);
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save Run Stats To"), "",
+             tr("CSV Files (*.csv);;JSON Files (*.json)"), NULL, QFileDialog::DontConfirmOverwrite);
+    if(fileName.isEmpty())
+    {
+        return;
+    }
+    _statsFile = fileName;
+    ui->txt_debug->append("Run stats will be saved to " + fileName);
 }
 
-bool microMouseServer::isWallForward()
-{
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        return mover->isWallTop();
-        break;
-    case dDOWN:
-        return mover->isWallBottom();
-        break;
-    case dLEFT:
-        return mover->isWallLeft();
-        break;
-    case dRIGHT:
-        return mover->isWallRight();
-        break;
-    }
-
-    return true;
-}
-bool microMouseServer::isWallLeft()
-{
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        return mover->isWallLeft();
-        break;
-    case dDOWN:
-        return mover->isWallRight();
-        break;
-    case dLEFT:
-        return mover->isWallBottom();
-        break;
-    case dRIGHT:
-        return mover->isWallTop();
-        break;
-    }
-    return true;
-}
-bool microMouseServer::isWallRight()
-{
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        return mover->isWallRight();
-        break;
-    case dDOWN:
-        return mover->isWallLeft();
-        break;
-    case dLEFT:
-        return mover->isWallTop();
-        break;
-    case dRIGHT:
-        return mover->isWallBottom();
-        break;
-    }
-    return true;
-}
-bool microMouseServer::moveForward()
-{
-    bool hasMoved = false;
-    QPoint newPos;
-    newPos.setX(this->maze->mouseX());
-    newPos.setY(this->maze->mouseY());
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        if(!mover->isWallTop())
+//one checkable entry per solver above the plugin actions, the one in use ticked
+void microMouseServer::listSolvers()
+{
+    QList<QAction*> old = _solverGroup->actions();
+    for(int i = 0; i < old.size(); i++)
+    {
+        delete old[i];
+    }
+    QAction *separator = ui->menuSolver->actions().first();
+    std::vector<solverEntry> &solvers = solverRegistry();
+    int count = (int)(solvers.size() + _plugins.size());
+    for(int i = 0; i < count; i++)
+    {
+        QString name;
+        if(i < (int)solvers.size())
         {
-            newPos.setY(newPos.y()+1);
-            this->maze->drawMouse(newPos, dUP);
-            hasMoved = true;
+            name = QString::fromStdString(solvers[i].name);
         }
-        break;
-    case dDOWN:
-        if(!mover->isWallBottom())
+        else
         {
-            newPos.setY(newPos.y()-1);
-            this->maze->drawMouse(newPos, dDOWN);
-            hasMoved = true;
+            const solverPlugin &plugin = *_plugins[i - solvers.size()];
+            name = QString::fromStdString(plugin.entry().name) + " (" + QFileInfo(QString::fromStdString(plugin.fileName())).fileName() + ")";
         }
-        break;
-    case dLEFT:
-        if(!mover->isWallLeft())
+        QAction *action = new QAction(name, _solverGroup);
+        action->setCheckable(true);
+        action->setChecked(i == _solverIndex);
+        action->setData(i);
+        ui->menuSolver->insertAction(separator, action);
+    }
+}
+
+//a fresh solver for the sim, it starts over like on a new maze
+void microMouseServer::useSolver(int index)
+{
+    this->stopRuns();
+    std::vector<solverEntry> &solvers = solverRegistry();
+    _solverIndex = index;
+    if(index == 0)
+    {
+        _sim->setSolver(NULL);
+        _solver.reset();
+    }
+    else
+    {
+        const solverEntry &entry = index < (int)solvers.size() ? solvers[index] : _plugins[index - solvers.size()]->entry();
+        mazeSolver *solver = entry.create();
+        _sim->setSolver(solver);
+        _solver.reset(solver);
+    }
+    this->listSolvers();
+}
+
+void microMouseServer::chooseSolver(QAction *action)
+{
+    this->useSolver(action->data().toInt());
+    ui->txt_debug->append("Runs use " + action->text());
+}
+
+//a file that is already loaded is loaded again, so rebuilding and picking it again works too
+void microMouseServer::loadPlugin()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Solver Plugin"), "./",
+             tr("Solver Plugins (*.so *.dylib *.dll)"));
+    if(fileName.isEmpty())
+    {
+        return;
+    }
+    std::string name = QFile::encodeName(fileName).constData();
+    size_t p = 0;
+    while(p < _plugins.size() && _plugins[p]->fileName() != name)
+    {
+        p++;
+    }
+    std::unique_ptr<solverPlugin> plugin(new solverPlugin);
+    solverPlugin *target = p < _plugins.size() ? _plugins[p].get() : plugin.get();
+    mazeError err = target->load(name.c_str());
+    if(err != MAZE_OK)
+    {
+        ui->txt_debug->append(QString(mazeErrorString(err)) + " " + QString::fromStdString(target->error()));
+        return;
+    }
+    if(p == _plugins.size())
+    {
+        _plugins.push_back(std::move(plugin));
+    }
+    this->useSolver((int)(solverRegistry().size() + p));
+    ui->txt_debug->append("Solver plugin " + QString::fromStdString(_plugins[p]->entry().name) + " loaded, runs use it");
+}
+
+//picks up rebuilt plugins, the solver in use is made again from the new code
+void microMouseServer::reloadPlugins()
+{
+    this->stopRuns();
+    for(size_t p = 0; p < _plugins.size(); p++)
+    {
+        QString fileName = QString::fromStdString(_plugins[p]->fileName());
+        mazeError err = _plugins[p]->reload();
+        if(err != MAZE_OK)
         {
-            newPos.setX(newPos.x()-1);
-            this->maze->drawMouse(newPos, dLEFT);
-            hasMoved = true;
+            ui->txt_debug->append(fileName + ": " + mazeErrorString(err) + " " + QString::fromStdString(_plugins[p]->error()));
         }
-        break;
-    case dRIGHT:
-        if(!mover->isWallRight())
+        else
         {
-            newPos.setX(newPos.x()+1);
-            this->maze->drawMouse(newPos, dRIGHT);
-            hasMoved = true;
+            ui->txt_debug->append("Reloaded " + fileName);
         }
-        break;
     }
+    if(_solverIndex >= (int)solverRegistry().size())
+    {
+        this->useSolver(_solverIndex);
+    }
+    else
+    {
+        this->listSolvers();
+    }
+}
 
-    return hasMoved;
+void microMouseServer::stopRuns()
+{
+    _runner->stop();
+    _frameTimer->stop();
+    _replayTimer->stop();
 }
-void microMouseServer::turnLeft()
+
+void microMouseServer::saveTrace()
 {
-    QPoint newPos;
-    newPos.setX(this->maze->mouseX());
-    newPos.setY(this->maze->mouseY());
-    switch(this->maze->mouseDir()){
-    case dUP:
-        this->maze->drawMouse(newPos, dLEFT);
-        break;
-    case dDOWN:
-        this->maze->drawMouse(newPos, dRIGHT);
-        break;
-    case dLEFT:
-        this->maze->drawMouse(newPos, dDOWN);
-        break;
-    case dRIGHT:
-        this->maze->drawMouse(newPos, dUP);
-        break;
+    this->stopRuns();
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save Run Trace"), "", tr("Run Traces (*.mtr)"));
+    if(fileName.isEmpty())
+    {
+        return;
+    }
+    if(!fileName.endsWith(".mtr"))
+    {
+        fileName += ".mtr";
     }
+    mazeError err = _trace.write(QFile::encodeName(fileName).constData());
+    ui->txt_debug->append(err == MAZE_OK ? "Run trace saved to file." : mazeErrorString(err));
+}
 
+void microMouseServer::loadTrace()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Run Trace"), "", tr("Run Traces (*.mtr)"));
+    if(fileName.isEmpty())
+    {
+        return;
+    }
+    this->stopRuns();
+    mazeError err = _trace.read(QFile::encodeName(fileName).constData());
+    if(err != MAZE_OK)
+    {
+        ui->txt_debug->append(mazeErrorString(err));
+        return;
+    }
+    //the trace only has the moves, walls come from whatever maze is loaded
+    if(_trace.mazeChecksum() != mazeChecksum(_sim->mazeData))
+    {
+        ui->txt_debug->append("Run trace was recorded on a different maze than the one loaded.");
+    }
+    ui->txt_debug->append("Run trace loaded");
+    this->replayTrace();
+}
+
+//plays _trace back at spn_replaySpeed ticks a second from the start
+void microMouseServer::replayTrace()
+{
+    this->stopRuns();
+    ui->txt_status->clear();
+    _replayPos = 0;
+    _replayState = _trace.startState();
+    ui->sld_replay->setRange(0, _trace.tickCount());
+    ui->sld_replay->setValue(0);
+    this->scrubTrace(0);
+    _replayTimer->start(1000/FRAME_RATE);
 }
-void microMouseServer::turnRight()
+
+void microMouseServer::replayStep()
 {
-    QPoint newPos;
-    newPos.setX(this->maze->mouseX());
-    newPos.setY(this->maze->mouseY());
-    switch(this->maze->mouseDir()){
-    case dUP:
-        this->maze->drawMouse(newPos, dRIGHT);
-        break;
-    case dDOWN:
-        this->maze->drawMouse(newPos, dLEFT);
-        break;
-    case dLEFT:
-        this->maze->drawMouse(newPos, dUP);
-        break;
-    case dRIGHT:
-        this->maze->drawMouse(newPos, dDOWN);
-        break;
+    _replayPos += (double)ui->spn_replaySpeed->value() / FRAME_RATE;
+    if(_replayPos >= _trace.tickCount())
+    {
+        _replayPos = _trace.tickCount();
+        _replayTimer->stop();
     }
+    ui->sld_replay->setValue((int)_replayPos);
 }
 
+//the slider is the replay position, dragging it jumps straight to that tick
+void microMouseServer::scrubTrace(int tick)
+{
+    //the trace is being recorded into
+    if(_runner->isRunning())
+    {
+        return;
+    }
+    if(tick != (int)_replayPos)
+    {
+        _replayPos = tick;
+    }
+    traceState state = _trace.seekTick(tick);
+
+    //playing forward shows what the AI printed on the way, a long jump doesn't
+    if(state.prints > _replayState.prints && state.prints - _replayState.prints <= 100)
+    {
+        for(size_t i = _replayState.prints; i < state.prints; i++)
+        {
+            ui->txt_status->append(_trace.print(i).c_str());
+        }
+    }
+    _replayState = state;
+    this->maze->drawMouse(QPoint(state.x+1, state.y+1), state.dir);
+}
 
+void microMouseServer::simPrint(const char *mesg)
+{
+    ui->txt_status->append(mesg);
+}
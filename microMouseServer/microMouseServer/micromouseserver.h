@@ -2,7 +2,13 @@
 #define MICROMOUSESERVER_H
 #include "mazeConst.h"
 #include "mazeBase.h"
+#include "mazeSim.h"
 #include "mazegui.h"
+#include "runTrace.h"
+#include "robotLink.h"
+#include "simRunner.h"
+#include "solverPlugin.h"
+#include "mazeEditor.h"
 #include <QMainWindow>
 #include <QGraphicsScene>
 #include <QGraphicsView>
@@ -11,6 +17,9 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QLineF>
 #include <QTimer>
+#include <QActionGroup>
+#include <memory>
+#include <vector>
 
 
 
@@ -18,7 +27,7 @@ namespace Ui {
 class microMouseServer;
 }
 
-class microMouseServer : public QMainWindow
+class microMouseServer : public QMainWindow, public simListener
 {
     Q_OBJECT
 
@@ -26,43 +35,76 @@ public:
     explicit microMouseServer(QWidget *parent = 0);
     ~microMouseServer();
 
+    void simPrint(const char *mesg);
+    void simFinished();
+
 private slots:
     void on_tabWidget_tabBarClicked(int index);
     void loadMaze();
     void saveMaze();
-    void addLeftWall(QPoint cell);
-    void addRightWall(QPoint cell);
-    void addTopWall(QPoint cell);
-    void addBottomWall(QPoint cell);
-    void removeRightWall(QPoint cell);
-    void removeLeftWall(QPoint cell);
-    void removeTopWall(QPoint cell);
-    void removeBottomWall(QPoint cell);
+    void generateMaze();
+    void startStroke();
+    void editWall(QPoint cell, Wall pos, bool isWall);
+    void finishStroke();
+    void editRect(QRect cells, bool isWall);
+    void undoEdit();
+    void redoEdit();
+    void mirrorLeftRight();
+    void mirrorTopBottom();
+    void rotateRight();
+    void rotateLeft();
+    void rotate180();
     void netComs();
     void connect2mouse();
     void startAI();
-    void studentAI();
+    void turboAI();
+    void changeRunSpeed(int index);
+    void drawFrame();
+    void saveTrace();
+    void loadTrace();
+    void replayTrace();
+    void replayStep();
+    void scrubTrace(int tick);
+    void chooseStatsFile();
+    void chooseSolver(QAction *action);
+    void loadPlugin();
+    void reloadPlugins();
 
 
 private:
-    bool isWallLeft();
-    bool isWallRight();
-    bool isWallForward();
-    bool moveForward();
-    void turnLeft();
-    void turnRight();
-    void foundFinish();
-    void printUI(const char *mesg);
-
     QTimer *_comTimer;
-    QTimer *_aiCallTimer;
-    static const int _mDelay = 100;
+    QTimer *_frameTimer;
+    //the AI runs on here, drawFrame() picks up what it did
+    simRunner *_runner;
+    //the last run is always recorded, replay only ever reads it
+    runTrace _trace;
+    traceState _replayState;
+    QTimer *_replayTimer;
+    double _replayPos;
+    //every finished run's stats go here when set, see saveRunStats()
+    QString _statsFile;
+    QString _mazeName;
+    //the real mouse when connected, runs drive it instead of the maze
+    robotLink _robot;
+    QString _robotSpec;
+    //the Solver menu, solverRegistry() then the loaded plugins. _solverIndex counts
+    //through both, 0 is the sim's own studentAI and needs no _solver
+    std::vector<std::unique_ptr<solverPlugin>> _plugins;
+    std::unique_ptr<mazeSolver> _solver;
+    int _solverIndex;
+    QActionGroup *_solverGroup;
+    //every wall edit goes through here so it can be undone
+    mazeEditor _editor;
     Ui::microMouseServer *ui;
     mazeGui *maze;
-    std::vector<QGraphicsLineItem*> backgroundGrid;
-    struct baseMapNode mazeData[MAZE_WIDTH][MAZE_HEIGHT];
+    mazeSim *_sim;
     void connectSignals();
-    void initMaze();
+    void stopRuns();
+    void showStats();
+    void listSolvers();
+    void useSolver(int index);
+    void transformMaze(mazeTransform how);
+    void showEditMenu();
 };
 
 #endif // MICROMOUSESERVER_H
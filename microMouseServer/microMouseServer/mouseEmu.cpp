@@ -0,0 +1,346 @@
+//mouseEmu - pretends to be the mouse at the other end of a robotLink, driving around
+//a maze file, so the whole link can be tried on one machine
+//
+//usage: mouseEmu [--tcp port | --udp port | --serial] [--delay ms] [--drop n] <maze file>
+//
+//--serial opens a pseudo terminal and prints its name, connect with serial:<name>.
+//--delay holds every status back to act like a slow mouse, --drop ignores every
+//n'th frame to show udp resends working.
+
+#include "mazeIO.h"
+#include "robotLink.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+//mDirection order, right turn is +1
+static const int emuDX[4] = {1, 0, -1, 0};
+static const int emuDY[4] = {0, -1, 0, 1};
+
+class emuMouse
+{
+public:
+    emuMouse(const baseMap &maze, int delayMs, int drop)
+        : _maze(maze), _delayMs(delayMs), _drop(drop), _frames(0) { this->restart(); }
+
+    //a new connection starts from the start cell with no frame answered yet
+    void restart()
+    {
+        _x = _maze.startX();
+        _y = _maze.startY();
+        _dir = dUP;
+        _answered = false;
+        _parser.reset();
+    }
+
+    //bytes in, any answers appended to out
+    void receive(const uint8_t *data, size_t length, std::vector<uint8_t> &out);
+
+private:
+    void answer(const robotFrame &frame, std::vector<uint8_t> &out);
+    void run(uint8_t command, uint8_t &blocked);
+
+    const baseMap &_maze;
+    int _delayMs, _drop;
+    long _frames;
+    int _x, _y;
+    mDirection _dir;
+    robotFrameParser _parser;
+    bool _answered;
+    uint8_t _lastSeq;
+    robotFrame _lastStatus;
+};
+
+void emuMouse::receive(const uint8_t *data, size_t length, std::vector<uint8_t> &out)
+{
+    robotFrame frame;
+    for(size_t i = 0; i < length; i++)
+    {
+        if(_parser.push(data[i], frame))
+        {
+            _frames++;
+            if(_drop > 0 && _frames % _drop == 0)
+            {
+                continue;
+            }
+            this->answer(frame, out);
+        }
+    }
+}
+
+void emuMouse::run(uint8_t command, uint8_t &blocked)
+{
+    switch(command)
+    {
+    case ROBOT_FORWARD:
+        if(_maze.wallMask(_x, _y) & (1 << _dir))
+        {
+            blocked++;
+        }
+        else
+        {
+            _x += emuDX[_dir];
+            _y += emuDY[_dir];
+        }
+        break;
+    case ROBOT_LEFT:
+        _dir = mDirection((_dir + 3) & 3);
+        break;
+    case ROBOT_RIGHT:
+        _dir = mDirection((_dir + 1) & 3);
+        break;
+    case ROBOT_RESET:
+        _x = _maze.startX();
+        _y = _maze.startY();
+        _dir = dUP;
+        break;
+    }
+}
+
+void emuMouse::answer(const robotFrame &frame, std::vector<uint8_t> &out)
+{
+    robotFrame reply;
+    reply.seq = frame.seq;
+    switch(frame.type)
+    {
+    case ROBOT_HELLO:
+        //a host saying hello starts a new run, udp has no connection to tell us
+    {
+        uint8_t blocked = 0;
+        this->run(ROBOT_RESET, blocked);
+        _answered = false;
+        reply.type = ROBOT_HELLO;
+        reply.length = 1;
+        reply.payload[0] = ROBOT_VERSION;
+        break;
+    }
+    case ROBOT_PING:
+        reply.type = ROBOT_PONG;
+        reply.length = frame.length;
+        memcpy(reply.payload, frame.payload, frame.length);
+        break;
+    case ROBOT_COMMANDS:
+        //a resend of the last frame gets the same answer, the commands already ran
+        if(!_answered || frame.seq != _lastSeq)
+        {
+            uint8_t blocked = 0;
+            for(int i = 0; i < frame.length; i++)
+            {
+                this->run(frame.payload[i], blocked);
+            }
+            //relativeWall bits, bit i is the wall at heading + i
+            int walls = _maze.wallMask(_x, _y), relative = 0;
+            for(int i = 0; i < 4; i++)
+            {
+                relative |= ((walls >> ((_dir + i) & 3)) & 1) << i;
+            }
+            _lastStatus.type = ROBOT_STATUS;
+            _lastStatus.seq = frame.seq;
+            _lastStatus.length = 3;
+            _lastStatus.payload[0] = relative;
+            _lastStatus.payload[1] = blocked;
+            _lastStatus.payload[2] = frame.length;
+            _lastSeq = frame.seq;
+            _answered = true;
+        }
+        if(_delayMs > 0)
+        {
+            usleep(_delayMs*1000);
+        }
+        reply = _lastStatus;
+        break;
+    default:
+        return;
+    }
+    encodeRobotFrame(reply, out);
+}
+
+static bool writeAll(int fd, const std::vector<uint8_t> &out)
+{
+    size_t sent = 0;
+    while(sent < out.size())
+    {
+        ssize_t n = write(fd, &out[sent], out.size() - sent);
+        if(n <= 0)
+        {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+//byte stream until the other end goes away
+static void serve(int fd, emuMouse &mouse)
+{
+    uint8_t buffer[512];
+    std::vector<uint8_t> out;
+    ssize_t n;
+    mouse.restart();
+    while((n = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        out.clear();
+        mouse.receive(buffer, n, out);
+        if(!out.empty() && !writeAll(fd, out))
+        {
+            break;
+        }
+    }
+}
+
+static int listenOn(int port, bool udp)
+{
+    int fd = socket(AF_INET6, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+    if(fd < 0)
+    {
+        return -1;
+    }
+    int on = 1, off = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    sockaddr_in6 address;
+    memset(&address, 0, sizeof(address));
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(port);
+    if(bind(fd, (sockaddr *)&address, sizeof(address)) != 0 || (!udp && listen(fd, 1) != 0))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: mouseEmu [--tcp port | --udp port | --serial] [--delay ms] [--drop n] <maze file>\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int tcpPort = 0, udpPort = 0, delayMs = 0, drop = 0;
+    bool serial = false;
+    const char *mazeFile = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--tcp") && i + 1 < argc)
+        {
+            tcpPort = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--udp") && i + 1 < argc)
+        {
+            udpPort = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--serial"))
+        {
+            serial = true;
+        }
+        else if(!strcmp(argv[i], "--delay") && i + 1 < argc)
+        {
+            delayMs = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--drop") && i + 1 < argc)
+        {
+            drop = atoi(argv[++i]);
+        }
+        else if(argv[i][0] == '-' || mazeFile)
+        {
+            usage();
+            return 1;
+        }
+        else
+        {
+            mazeFile = argv[i];
+        }
+    }
+    if(!mazeFile || (!tcpPort && !udpPort && !serial))
+    {
+        usage();
+        return 1;
+    }
+
+    baseMap maze;
+    mazeError err = readMaze(mazeFile, maze);
+    if(err != MAZE_OK)
+    {
+        fprintf(stderr, "%s: %s\n", mazeFile, mazeErrorString(err));
+        return 1;
+    }
+    emuMouse mouse(maze, delayMs, drop);
+
+    if(serial)
+    {
+        int fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if(fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+        {
+            perror("mouseEmu");
+            return 1;
+        }
+        termios tio;
+        tcgetattr(fd, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+        printf("listening on serial:%s\n", ptsname(fd));
+        fflush(stdout);
+        //the master reads EIO while nobody has the other end open, wait for someone
+        for(;;)
+        {
+            serve(fd, mouse);
+            usleep(100000);
+        }
+    }
+
+    int fd = listenOn(tcpPort ? tcpPort : udpPort, udpPort != 0);
+    if(fd < 0)
+    {
+        perror("mouseEmu");
+        return 1;
+    }
+    printf("listening on %s port %d\n", tcpPort ? "tcp" : "udp", tcpPort ? tcpPort : udpPort);
+    fflush(stdout);
+
+    if(tcpPort)
+    {
+        for(;;)
+        {
+            int client = accept(fd, NULL, NULL);
+            if(client < 0)
+            {
+                continue;
+            }
+            int on = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            serve(client, mouse);
+            close(client);
+        }
+    }
+
+    //udp, every datagram is answered to whoever sent it
+    uint8_t buffer[512];
+    std::vector<uint8_t> out;
+    for(;;)
+    {
+        sockaddr_storage from;
+        socklen_t fromLength = sizeof(from);
+        ssize_t n = recvfrom(fd, buffer, sizeof(buffer), 0, (sockaddr *)&from, &fromLength);
+        if(n <= 0)
+        {
+            continue;
+        }
+        out.clear();
+        mouse.receive(buffer, n, out);
+        if(!out.empty())
+        {
+            sendto(fd, out.data(), out.size(), 0, (sockaddr *)&from, fromLength);
+        }
+    }
+}
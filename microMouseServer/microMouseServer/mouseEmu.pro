@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# Stand in for the real mouse on a robotLink, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       -= core gui
+# only a few sim core files, not simCore.pri, so the standard is set here
+CONFIG   += console c++11
+CONFIG   -= app_bundle qt
+
+TARGET = mouseEmu
+TEMPLATE = app
+
+SOURCES += mouseEmu.cpp \
+    mazeBase.cpp \
+    mazeIO.cpp \
+    mazeParser.cpp \
+    robotLink.cpp
+
+HEADERS += mazeConst.h \
+    mazeBase.h \
+    mazeIO.h \
+    mazeParser.h \
+    robotLink.h
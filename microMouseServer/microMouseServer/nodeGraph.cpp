@@ -0,0 +1,73 @@
+#include "nodeGraph.h"
+
+const int nodeGraph::NONE;
+const int nodeGraph::DEAD_END;
+
+nodeGraph::nodeGraph()
+{
+    _count = 0;
+    _generation = 1;
+    _width = 0;
+    _height = 0;
+}
+
+void nodeGraph::reset(int width, int height)
+{
+    _count = 0;
+    if(width != _width || height != _height)
+    {
+        _width = width;
+        _height = height;
+        _cells.assign((size_t)width*height, cellSlot());
+        _generation = 0;
+    }
+    //a wrapped generation could match a stale cell, clear them for real then
+    if(++_generation == 0)
+    {
+        _cells.assign((size_t)width*height, cellSlot());
+        _generation = 1;
+    }
+}
+
+int nodeGraph::addNode(int x, int y)
+{
+    if(_count == (int)_nodes.size())
+    {
+        _nodes.push_back(graphNode());
+    }
+    graphNode &node = _nodes[_count];
+    node.id = _count;
+    node.x = x;
+    node.y = y;
+    for(int i = 0; i < 4; i++)
+    {
+        node.adj[i] = NONE;
+        node.dist[i] = 0;
+    }
+    node.d = INT_MAX;
+    node.prev = NONE;
+    node.prevSlot = NONE;
+    this->setNodeAt(x, y, _count);
+    return _count++;
+}
+
+void nodeGraph::setNodeAt(int x, int y, int node)
+{
+    if(!this->inside(x, y))
+    {
+        return;
+    }
+    cellSlot &slot = _cells[(size_t)y*_width + x];
+    slot.generation = _generation;
+    slot.node = node;
+}
+
+void nodeGraph::link(int from, int slot, int to, int dist)
+{
+    if(from < 0)
+    {
+        return;
+    }
+    _nodes[from].adj[slot] = to;
+    _nodes[from].dist[slot] = dist;
+}
@@ -0,0 +1,72 @@
+#ifndef NODEGRAPH_H
+#define NODEGRAPH_H
+
+#include <climits>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//one junction of the corridor graph, the four slots are whatever directions the AI uses
+struct graphNode
+{
+    int id, x, y;
+    int adj[4];         //node each way, nodeGraph::NONE if not explored yet or nodeGraph::DEAD_END
+    int dist[4];        //steps to that node
+    int d;              //shortest distance found so far, INT_MAX until one is
+    int prev;           //node before this one on the shortest path, NONE at the start
+    int prevSlot;       //slot of prev the shortest path leaves by
+};
+
+//Corridor graph for the AI. Nodes live in one arena and are referred to by index,
+//the arena is only ever grown so after the first maze nothing is allocated. It also
+//remembers which cell holds which node. reset() is O(1): the node count goes back to
+//0 and a new generation makes every cell look empty again.
+class nodeGraph
+{
+public:
+    static const int NONE = -1;
+    static const int DEAD_END = -2;
+
+    nodeGraph();
+
+    void reset(int width, int height);
+
+    int addNode(int x, int y);
+    int size() const { return _count; }
+    graphNode &operator[](int id) { return _nodes[id]; }
+    const graphNode &operator[](int id) const { return _nodes[id]; }
+
+    //node in a cell, NONE if there isn't one or the cell is outside the maze. A cell
+    //can also be marked DEAD_END, marking one outside the maze does nothing
+    int nodeAt(int x, int y) const
+    {
+        if(!this->inside(x, y))
+        {
+            return NONE;
+        }
+        const cellSlot &slot = _cells[(size_t)y*_width + x];
+        return slot.generation == _generation ? slot.node : NONE;
+    }
+    void setNodeAt(int x, int y, int node);
+
+    //sets one slot, links from NONE or DEAD_END are ignored
+    void link(int from, int slot, int to, int dist);
+
+private:
+    struct cellSlot
+    {
+        uint32_t generation;
+        int node;
+    };
+
+    //negative x or y wraps round to a huge unsigned and fails the same compare
+    bool inside(int x, int y) const { return (unsigned)x < (unsigned)_width && (unsigned)y < (unsigned)_height; }
+
+    std::vector<graphNode> _nodes;
+    int _count;
+    std::vector<cellSlot> _cells;
+    uint32_t _generation;
+    int _width, _height;
+};
+
+#endif // NODEGRAPH_H
@@ -0,0 +1,14 @@
+#ifndef NULLBUFFER_H
+#define NULLBUFFER_H
+
+#include <streambuf>
+
+//a stream buffer that drops everything, the command line tools point std::cout at
+//one so the AI's debug prints don't interleave with their tables
+class nullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) { return c; }
+};
+
+#endif // NULLBUFFER_H
@@ -0,0 +1,203 @@
+#include "pathSearch.h"
+#include <algorithm>
+#include <cstdlib>
+
+//mDirection order, right turn is +1
+static const int pathDX[4] = {1, 0, -1, 0};
+static const int pathDY[4] = {0, -1, 0, 1};
+
+void indexedHeap::reset(int items)
+{
+    _heap.clear();
+    _key.assign(items, 0);
+    _pos.assign(items, -1);
+}
+
+void indexedHeap::place(int i, int item)
+{
+    _heap[i] = item;
+    _pos[item] = i;
+}
+
+void indexedHeap::up(int i)
+{
+    int item = _heap[i];
+    while(i > 0 && _key[_heap[(i-1)/2]] > _key[item])
+    {
+        this->place(i, _heap[(i-1)/2]);
+        i = (i-1)/2;
+    }
+    this->place(i, item);
+}
+
+void indexedHeap::down(int i)
+{
+    int item = _heap[i], n = (int)_heap.size();
+    for(;;)
+    {
+        int child = 2*i + 1;
+        if(child >= n)
+        {
+            break;
+        }
+        if(child + 1 < n && _key[_heap[child+1]] < _key[_heap[child]])
+        {
+            child++;
+        }
+        if(_key[_heap[child]] >= _key[item])
+        {
+            break;
+        }
+        this->place(i, _heap[child]);
+        i = child;
+    }
+    this->place(i, item);
+}
+
+void indexedHeap::push(int item, uint64_t key)
+{
+    if(_pos[item] >= 0)
+    {
+        if(key < _key[item])
+        {
+            _key[item] = key;
+            this->up(_pos[item]);
+        }
+        return;
+    }
+    _key[item] = key;
+    _heap.push_back(item);
+    this->up((int)_heap.size() - 1);
+}
+
+int indexedHeap::pop()
+{
+    int top = _heap[0];
+    _pos[top] = -1;
+    int last = _heap.back();
+    _heap.pop_back();
+    if(!_heap.empty())
+    {
+        _heap[0] = last;
+        this->down(0);
+    }
+    return top;
+}
+
+//f first, then the deeper of two equal f so ties run towards the goal
+static inline uint64_t searchKey(uint32_t g, uint32_t h)
+{
+    return ((uint64_t)(g + h) << 32) | (0xFFFFFFFFu - g);
+}
+
+//Among corridors of the same length the one through fewer nodes wins, the AI follows
+//one corridor per tick. Cost is (distance, nodes) packed as distance*scale + nodes,
+//scaling the heuristic the same way keeps it admissible
+int pathSearch::run(nodeGraph &graph, int from, int to)
+{
+    _expanded = 0;
+    for(int i = 0; i < graph.size(); i++)
+    {
+        graph[i].d = INT_MAX;
+        graph[i].prev = nodeGraph::NONE;
+        graph[i].prevSlot = nodeGraph::NONE;
+    }
+    if(from < 0 || to < 0)
+    {
+        return -1;
+    }
+
+    uint64_t scale = graph.size() + 1;
+    int tx = graph[to].x, ty = graph[to].y;
+    _hops.resize(graph.size());
+    _heap.reset(graph.size());
+    graph[from].d = 0;
+    _hops[from] = 0;
+    _heap.push(from, (abs(graph[from].x - tx) + abs(graph[from].y - ty))*scale);
+    while(!_heap.empty())
+    {
+        int id = _heap.pop();
+        _expanded++;
+        if(id == to)
+        {
+            return graph[to].d;
+        }
+        graphNode &node = graph[id];
+        for(int slot = 0; slot < 4; slot++)
+        {
+            int next = node.adj[slot];
+            if(next < 0)
+            {
+                continue;
+            }
+            int d = node.d + node.dist[slot], hops = _hops[id] + 1;
+            graphNode &other = graph[next];
+            if(d < other.d || (d == other.d && hops < _hops[next]))
+            {
+                other.d = d;
+                other.prev = id;
+                other.prevSlot = slot;
+                _hops[next] = hops;
+                _heap.push(next, (d + abs(other.x - tx) + abs(other.y - ty))*scale + hops);
+            }
+        }
+    }
+    return -1;
+}
+
+int pathSearch::run(const baseMap &maze, int startX, int startY, int goalX, int goalY, std::vector<mDirection> *path)
+{
+    int width = maze.width();
+    int cells = width*maze.height();
+    _expanded = 0;
+    _g.assign(cells, 0xFFFFFFFFu);
+    _from.resize(cells);
+    _heap.reset(cells);
+
+    int start = startY*width + startX, goal = goalY*width + goalX;
+    _g[start] = 0;
+    _heap.push(start, searchKey(0, abs(startX - goalX) + abs(startY - goalY)));
+    while(!_heap.empty())
+    {
+        int cell = _heap.pop();
+        _expanded++;
+        if(cell == goal)
+        {
+            break;
+        }
+        int x = cell % width, y = cell / width;
+        bool open[4] = {!maze.isWallRight(x, y), !maze.isWallBottom(x, y), !maze.isWallLeft(x, y), !maze.isWallTop(x, y)};
+        for(int dir = 0; dir < 4; dir++)
+        {
+            if(!open[dir])
+            {
+                continue;
+            }
+            int nx = x + pathDX[dir], ny = y + pathDY[dir], next = ny*width + nx;
+            uint32_t g = _g[cell] + 1;
+            if(g < _g[next])
+            {
+                _g[next] = g;
+                _from[next] = dir;
+                _heap.push(next, searchKey(g, abs(nx - goalX) + abs(ny - goalY)));
+            }
+        }
+    }
+    if(_g[goal] == 0xFFFFFFFFu)
+    {
+        return -1;
+    }
+
+    if(path)
+    {
+        size_t first = path->size();
+        for(int cell = goal; cell != start; )
+        {
+            mDirection dir = mDirection(_from[cell]);
+            path->push_back(dir);
+            cell -= pathDX[dir] + pathDY[dir]*width;
+        }
+        std::reverse(path->begin() + first, path->end());
+    }
+    return _g[goal];
+}
@@ -0,0 +1,59 @@
+#ifndef PATHSEARCH_H
+#define PATHSEARCH_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include "nodeGraph.h"
+#include <stdint.h>
+#include <vector>
+
+//Binary min heap over items 0..n-1 that knows where every item sits, so a better
+//key for an item already in the heap moves it up instead of adding a second copy
+class indexedHeap
+{
+public:
+    void reset(int items);
+    bool empty() const { return _heap.empty(); }
+    bool contains(int item) const { return _pos[item] >= 0; }
+    //adds item or lowers its key, a higher key is ignored
+    void push(int item, uint64_t key);
+    int pop();
+
+private:
+    void up(int i);
+    void down(int i);
+    void place(int i, int item);
+
+    std::vector<int> _heap;
+    std::vector<uint64_t> _key;
+    std::vector<int> _pos;
+};
+
+//A* with a Manhattan heuristic, a corridor or a cell is never shorter than that so
+//the first path found is the shortest one. Every node or cell remembers the edge it
+//was reached by, following those back gives the path without searching again.
+//Keep one around, the scratch arrays are reused between searches.
+class pathSearch
+{
+public:
+    //over the AI's corridor graph. Fills d, prev and prevSlot of the nodes it
+    //reached, returns the distance or -1 if to can't be reached. Of two equally
+    //short paths the one through fewer nodes is taken
+    int run(nodeGraph &graph, int from, int to);
+
+    //over the cells of a maze, 0 based. Appends the moves from start to goal to
+    //path if given, returns the number of steps or -1
+    int run(const baseMap &maze, int startX, int startY, int goalX, int goalY, std::vector<mDirection> *path = NULL);
+
+    //cells or nodes taken off the heap by the last search
+    long expanded() const { return _expanded; }
+
+private:
+    indexedHeap _heap;
+    std::vector<uint32_t> _g;
+    std::vector<uint8_t> _from;
+    std::vector<int> _hops;
+    long _expanded;
+};
+
+#endif // PATHSEARCH_H
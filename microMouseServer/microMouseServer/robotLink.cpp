@@ -0,0 +1,366 @@
+#include "robotLink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+uint16_t robotCrc(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for(size_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for(int bit = 0; bit < 8; bit++)
+        {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+void encodeRobotFrame(const robotFrame &frame, std::vector<uint8_t> &out)
+{
+    size_t start = out.size();
+    out.push_back(ROBOT_SYNC);
+    out.push_back(frame.type);
+    out.push_back(frame.seq);
+    out.push_back(frame.length);
+    out.insert(out.end(), frame.payload, frame.payload + frame.length);
+    uint16_t crc = robotCrc(&out[start + 1], frame.length + 3);
+    out.push_back(crc & 0xFF);
+    out.push_back(crc >> 8);
+}
+
+bool robotFrameParser::push(uint8_t byte, robotFrame &frame)
+{
+    if(_have == 0 && byte != ROBOT_SYNC)
+    {
+        return false;
+    }
+    _buffer[_have++] = byte;
+    if(_have < 4 || _have < (size_t)_buffer[3] + 6)
+    {
+        return false;
+    }
+
+    size_t length = _buffer[3];
+    uint16_t crc = _buffer[length + 4] | _buffer[length + 5] << 8;
+    if(crc != robotCrc(_buffer + 1, length + 3))
+    {
+        //the sync byte was probably noise, run the rest through again from the next one
+        uint8_t rest[sizeof(_buffer)];
+        size_t count = _have - 1;
+        memcpy(rest, _buffer + 1, count);
+        _have = 0;
+        bool found = false;
+        for(size_t i = 0; i < count; i++)
+        {
+            found |= this->push(rest[i], frame);
+        }
+        return found;
+    }
+    frame.type = _buffer[1];
+    frame.seq = _buffer[2];
+    frame.length = (uint8_t)length;
+    memcpy(frame.payload, _buffer + 4, length);
+    _have = 0;
+    return true;
+}
+
+robotLink::robotLink()
+{
+    _fd = -1;
+    _seq = 0;
+    _blocked = 0;
+    _trips = 0;
+    _lastRtt = _totalRtt = _maxRtt = 0;
+}
+
+robotLink::~robotLink()
+{
+    this->close();
+}
+
+#ifdef _WIN32
+
+mazeError robotLink::open(const char *)
+{
+    return MAZE_ERR_LINK;
+}
+
+void robotLink::close()
+{
+}
+
+bool robotLink::send(uint8_t, const uint8_t *, size_t)
+{
+    return false;
+}
+
+bool robotLink::receive(uint8_t, robotFrame &, int)
+{
+    return false;
+}
+
+#else
+
+static int openSocket(const std::string &address, bool udp)
+{
+    size_t colon = address.rfind(':');
+    if(colon == std::string::npos)
+    {
+        return -1;
+    }
+    std::string host = address.substr(0, colon), port = address.substr(colon + 1);
+
+    addrinfo hints, *found;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = udp ? SOCK_DGRAM : SOCK_STREAM;
+    if(getaddrinfo(host.c_str(), port.c_str(), &hints, &found) != 0)
+    {
+        return -1;
+    }
+    int fd = -1;
+    for(addrinfo *a = found; a && fd < 0; a = a->ai_next)
+    {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if(fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    if(fd >= 0 && !udp)
+    {
+        //commands are tiny, don't let Nagle sit on them
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    return fd;
+}
+
+static speed_t baudRate(int baud)
+{
+    switch(baud)
+    {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 230400: return B230400;
+    default: return B115200;
+    }
+}
+
+static int openSerial(const std::string &device)
+{
+    std::string path = device;
+    int baud = 115200;
+    size_t colon = device.rfind(':');
+    if(colon != std::string::npos)
+    {
+        path = device.substr(0, colon);
+        baud = atoi(device.c_str() + colon + 1);
+    }
+    int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY);
+    if(fd < 0)
+    {
+        return -1;
+    }
+    termios tio;
+    if(tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, baudRate(baud));
+        cfsetospeed(&tio, baudRate(baud));
+        tio.c_cflag |= CLOCAL | CREAD;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+mazeError robotLink::open(const char *spec)
+{
+    this->close();
+    std::string s = spec;
+    if(s.compare(0, 4, "tcp:") == 0)
+    {
+        _fd = openSocket(s.substr(4), false);
+    }
+    else if(s.compare(0, 4, "udp:") == 0)
+    {
+        _fd = openSocket(s.substr(4), true);
+    }
+    else if(s.compare(0, 7, "serial:") == 0)
+    {
+        _fd = openSerial(s.substr(7));
+    }
+    if(_fd < 0)
+    {
+        return MAZE_ERR_LINK;
+    }
+
+    _parser.reset();
+    _queue.clear();
+    _blocked = 0;
+    _trips = 0;
+    _lastRtt = _totalRtt = _maxRtt = 0;
+    robotFrame reply;
+    uint8_t version = ROBOT_VERSION;
+    if(!this->request(ROBOT_HELLO, &version, 1, reply))
+    {
+        this->close();
+        return MAZE_ERR_LINK;
+    }
+    if(reply.length < 1 || reply.payload[0] != ROBOT_VERSION)
+    {
+        this->close();
+        return MAZE_ERR_PROTOCOL;
+    }
+    return MAZE_OK;
+}
+
+void robotLink::close()
+{
+    if(_fd >= 0)
+    {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool robotLink::send(uint8_t type, const uint8_t *payload, size_t length)
+{
+    robotFrame frame;
+    frame.type = type;
+    frame.seq = _seq;
+    frame.length = (uint8_t)length;
+    memcpy(frame.payload, payload, length);
+    _out.clear();
+    encodeRobotFrame(frame, _out);
+    size_t sent = 0;
+    while(sent < _out.size())
+    {
+        ssize_t n = write(_fd, &_out[sent], _out.size() - sent);
+        if(n <= 0)
+        {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+//waits in poll() for a frame of type answering the current seq, older answers are dropped
+bool robotLink::receive(uint8_t type, robotFrame &frame, int timeoutMs)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    uint8_t buffer[512];
+    for(;;)
+    {
+        int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()).count();
+        pollfd p = {_fd, POLLIN, 0};
+        if(left < 0 || poll(&p, 1, left) <= 0)
+        {
+            return false;
+        }
+        ssize_t n = read(_fd, buffer, sizeof(buffer));
+        if(n <= 0)
+        {
+            return false;
+        }
+        bool found = false;
+        for(ssize_t i = 0; i < n; i++)
+        {
+            robotFrame got;
+            if(_parser.push(buffer[i], got) && got.type == type && got.seq == _seq)
+            {
+                frame = got;
+                found = true;
+            }
+        }
+        if(found)
+        {
+            return true;
+        }
+    }
+}
+
+#endif
+
+//one frame out and its answer back, resent on a timeout in case udp lost either
+bool robotLink::request(uint8_t type, const uint8_t *payload, size_t length, robotFrame &reply)
+{
+    if(_fd < 0)
+    {
+        return false;
+    }
+    _seq++;
+    uint8_t answer = type;
+    if(type == ROBOT_COMMANDS) answer = ROBOT_STATUS;
+    if(type == ROBOT_PING) answer = ROBOT_PONG;
+    for(int attempt = 0; attempt < ROBOT_RETRIES; attempt++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if(!this->send(type, payload, length))
+        {
+            break;
+        }
+        if(this->receive(answer, reply, ROBOT_TIMEOUT_MS))
+        {
+            _lastRtt = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            _totalRtt += _lastRtt;
+            _maxRtt = std::max(_maxRtt, _lastRtt);
+            _trips++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void robotLink::queue(robotCommand command)
+{
+    _queue.push_back((uint8_t)command);
+}
+
+int robotLink::exchange()
+{
+    robotFrame reply;
+    size_t sent = 0;
+    do
+    {
+        size_t length = std::min(_queue.size() - sent, (size_t)ROBOT_MAX_PAYLOAD);
+        if(!this->request(ROBOT_COMMANDS, _queue.data() + sent, length, reply) || reply.length < 3)
+        {
+            _queue.clear();
+            return -1;
+        }
+        _blocked += reply.payload[1];
+        sent += length;
+    }
+    while(sent < _queue.size());
+    _queue.clear();
+    return reply.payload[0] & 15;
+}
+
+bool robotLink::ping()
+{
+    robotFrame reply;
+    uint8_t payload[8];
+    memset(payload, 0, sizeof(payload));
+    return this->request(ROBOT_PING, payload, sizeof(payload), reply);
+}
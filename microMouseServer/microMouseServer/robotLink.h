@@ -0,0 +1,110 @@
+#ifndef ROBOTLINK_H
+#define ROBOTLINK_H
+
+#include "mazeIO.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//Link to a real mouse (or mouseEmu) over tcp, udp or a serial port. Every frame is
+//  0xA5, type, seq, length, payload[length], crc16 (CCITT, little endian)
+//with the crc over type to the end of the payload. The host sends COMMANDS frames,
+//one command byte each, and the mouse answers every one with a STATUS frame that
+//carries the same seq, so a frame resent after a lost udp packet is answered again
+//without being run twice.
+#define ROBOT_SYNC 0xA5
+#define ROBOT_VERSION 1
+#define ROBOT_MAX_PAYLOAD 255
+#define ROBOT_TIMEOUT_MS 500
+#define ROBOT_RETRIES 3
+
+enum robotFrameType
+{
+    ROBOT_HELLO = 1,        //payload: version. Sent by the host on connect and echoed
+    ROBOT_COMMANDS = 2,     //payload: robotCommand bytes, run in order
+    ROBOT_STATUS = 3,       //payload: relativeWall bits after the commands, forward moves that hit a wall, commands run
+    ROBOT_PING = 4,         //payload: anything, echoed back in a PONG
+    ROBOT_PONG = 5
+};
+
+enum robotCommand
+{
+    ROBOT_FORWARD = 1,
+    ROBOT_LEFT = 2,
+    ROBOT_RIGHT = 3,
+    ROBOT_RESET = 4         //back to the start cell facing up, only mouseEmu can do that by itself
+};
+
+struct robotFrame
+{
+    uint8_t type;
+    uint8_t seq;
+    uint8_t length;
+    uint8_t payload[ROBOT_MAX_PAYLOAD];
+};
+
+uint16_t robotCrc(const uint8_t *data, size_t length);
+void encodeRobotFrame(const robotFrame &frame, std::vector<uint8_t> &out);
+
+//rebuilds frames out of a byte stream, whatever size the reads come in. Bad
+//frames are dropped and it hunts for the next sync byte
+class robotFrameParser
+{
+public:
+    robotFrameParser() { this->reset(); }
+    void reset() { _have = 0; }
+    //true when byte completed a good frame, which is then in frame
+    bool push(uint8_t byte, robotFrame &frame);
+
+private:
+    uint8_t _buffer[ROBOT_MAX_PAYLOAD + 6];
+    size_t _have;
+};
+
+//Host end of the link. Moves and turns are only queued, they go out together with
+//the next exchange(), which waits for the mouse to answer with the walls it sees.
+//A blocking wait on the socket rather than a poll loop, so the AI runs again as
+//soon as the answer is in.
+class robotLink
+{
+public:
+    robotLink();
+    ~robotLink();
+
+    //tcp:host:port, udp:host:port or serial:/dev/ttyX[:baud]
+    mazeError open(const char *spec);
+    void close();
+    bool isOpen() const { return _fd >= 0; }
+
+    void queue(robotCommand command);
+    bool hasQueued() const { return !_queue.empty(); }
+    //sends the queue and waits for the status, relativeWall bits or -1 if the mouse
+    //didn't answer after ROBOT_RETRIES tries
+    int exchange();
+    //round trip of an empty frame, false if it got no answer
+    bool ping();
+
+    //forward moves the mouse reported blocked, the host thought they were open
+    long blockedMoves() const { return _blocked; }
+    //round trips in microseconds over every exchange and ping
+    double lastRtt() const { return _lastRtt; }
+    double averageRtt() const { return _trips ? _totalRtt / _trips : 0; }
+    double maxRtt() const { return _maxRtt; }
+    long roundTrips() const { return _trips; }
+
+private:
+    bool send(uint8_t type, const uint8_t *payload, size_t length);
+    bool receive(uint8_t type, robotFrame &frame, int timeoutMs);
+    bool request(uint8_t type, const uint8_t *payload, size_t length, robotFrame &reply);
+
+    int _fd;
+    uint8_t _seq;
+    std::vector<uint8_t> _queue;
+    std::vector<uint8_t> _out;
+    robotFrameParser _parser;
+    long _blocked;
+    long _trips;
+    double _lastRtt, _totalRtt, _maxRtt;
+};
+
+#endif // ROBOTLINK_H
@@ -0,0 +1,121 @@
+#include "routePlanner.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+//mDirection order, right turn is +1
+static const int routeDX[4] = {1, 0, -1, 0};
+static const int routeDY[4] = {0, -1, 0, 1};
+
+routePlanner::routePlanner()
+{
+    _expanded = 0;
+}
+
+void routePlanner::setCosts(const motionCost &cost)
+{
+    _cost = cost;
+}
+
+static bool routeOpen(const baseMap &maze, int x, int y, int dir)
+{
+    switch(dir)
+    {
+    case dRIGHT:
+        return !maze.isWallRight(x, y);
+    case dDOWN:
+        return !maze.isWallBottom(x, y);
+    case dLEFT:
+        return !maze.isWallLeft(x, y);
+    case dUP:
+        return !maze.isWallTop(x, y);
+    }
+    return false;
+}
+
+//A* over state = cell*4 + heading. No cell is ever crossed quicker than fastCell,
+//so the Manhattan distance at that speed never overestimates
+long routePlanner::plan(const baseMap &maze, int startX, int startY, mDirection heading, int goalX, int goalY, std::vector<routeLeg> *route)
+{
+    int width = maze.width();
+    size_t stateCount = (size_t)4*width*maze.height();
+    _expanded = 0;
+    if(stateCount > INT_MAX)
+    {
+        return -1;
+    }
+    int states = (int)stateCount;
+    _g.assign(states, 0xFFFFFFFFu);
+    _from.resize(states);
+    _heap.reset(states);
+
+    int start = (startY*width + startX)*4 + heading;
+    int goal = -1;
+    _g[start] = 0;
+    _heap.push(start, (uint64_t)(abs(startX - goalX) + abs(startY - goalY))*_cost.fastCell);
+    while(!_heap.empty())
+    {
+        int state = _heap.pop();
+        _expanded++;
+        int dir = state & 3, cell = state >> 2;
+        int x = cell % width, y = cell / width;
+        if(x == goalX && y == goalY)
+        {
+            goal = state;
+            break;
+        }
+        uint32_t g = _g[state];
+
+        //turn on the spot
+        const int turns[3] = {1, 3, 2};
+        for(int i = 0; i < 3; i++)
+        {
+            int next = cell*4 + ((dir + turns[i]) & 3);
+            uint32_t cost = g + (turns[i] == 2 ? _cost.uTurn : _cost.turn);
+            if(cost < _g[next])
+            {
+                _g[next] = cost;
+                _from[next] = state;
+                _heap.push(next, cost + (uint64_t)(abs(x - goalX) + abs(y - goalY))*_cost.fastCell);
+            }
+        }
+
+        //every straight run that fits from here
+        uint32_t cost = g;
+        int nx = x, ny = y;
+        for(int k = 0; routeOpen(maze, nx, ny, dir); k++)
+        {
+            nx += routeDX[dir];
+            ny += routeDY[dir];
+            cost += _cost.cellCost(k);
+            int next = (ny*width + nx)*4 + dir;
+            if(cost < _g[next])
+            {
+                _g[next] = cost;
+                _from[next] = state;
+                _heap.push(next, cost + (uint64_t)(abs(nx - goalX) + abs(ny - goalY))*_cost.fastCell);
+            }
+        }
+    }
+    if(goal < 0)
+    {
+        return -1;
+    }
+
+    if(route)
+    {
+        size_t first = route->size();
+        for(int state = goal; state != start; state = _from[state])
+        {
+            int prev = _from[state];
+            if((prev & 3) == (state & 3))
+            {
+                int cells = abs((state >> 2) - (prev >> 2));
+                routeLeg leg = {mDirection(state & 3), (state & 1) ? cells / width : cells};
+                route->push_back(leg);
+            }
+        }
+        std::reverse(route->begin() + first, route->end());
+    }
+    return _g[goal];
+}
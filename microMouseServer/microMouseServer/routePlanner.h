@@ -0,0 +1,47 @@
+#ifndef ROUTEPLANNER_H
+#define ROUTEPLANNER_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include "mazeSim.h"
+#include "pathSearch.h"
+#include <stdint.h>
+#include <vector>
+
+//one straight of a route: turn to face heading, then move forward cells times
+struct routeLeg
+{
+    mDirection heading;
+    int cells;
+};
+
+//Fastest route rather than shortest. Searches (cell, heading) states with the
+//mouse's motionCost: a state can run straight any number of open cells or turn on
+//the spot. A run only gets cheaper per cell the longer it is, so the best route
+//never stops in the middle of a straight and every leg is one whole run.
+class routePlanner
+{
+public:
+    routePlanner();
+
+    void setCosts(const motionCost &cost);
+    const motionCost &costs() const { return _cost; }
+
+    //walls set in maze are the ones the mouse knows about, everything else counts
+    //as open. Cells are 0 based, the mouse may end up facing any way on the goal.
+    //Appends the legs to route if given, returns the estimated time in ms or -1. States
+    //are int indices, so a maze of more than 2^29 cells is -1 straight away
+    long plan(const baseMap &maze, int startX, int startY, mDirection heading, int goalX, int goalY, std::vector<routeLeg> *route = NULL);
+
+    //states taken off the heap by the last plan
+    long expanded() const { return _expanded; }
+
+private:
+    motionCost _cost;
+    indexedHeap _heap;
+    std::vector<uint32_t> _g;
+    std::vector<int> _from;     //state this one was reached from
+    long _expanded;
+};
+
+#endif // ROUTEPLANNER_H
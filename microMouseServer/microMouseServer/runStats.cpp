@@ -0,0 +1,118 @@
+#include "runStats.h"
+#include <cstring>
+
+void runStats::clear()
+{
+    aiCalls = 0;
+    moves = 0;
+    blocked = 0;
+    crowdedTicks = 0;
+    extraMoves = 0;
+    maxTickMoves = 0;
+    turns = 0;
+    sensors = 0;
+    cellsVisited = 0;
+    runTime = 0;
+    aiNs = 0;
+    memset(histogram, 0, sizeof(histogram));
+}
+
+//upper end of a histogram bucket as text, 1us rather than 1024ns
+static std::string bucketLimit(int bucket)
+{
+    char text[32];
+    uint64_t ns = (uint64_t)1 << bucket;
+    if(ns < 1000) snprintf(text, sizeof(text), "%dns", (int)ns);
+    else if(ns < 1000000) snprintf(text, sizeof(text), "%dus", (int)(ns / 1000));
+    else snprintf(text, sizeof(text), "%dms", (int)(ns / 1000000));
+    return text;
+}
+
+std::string runStats::summary() const
+{
+    char text[512];
+    snprintf(text, sizeof(text),
+             "studentAI calls: %ld\nmoves: %ld (%ld blocked)\ncalls moving more than once: %ld (%ld extra moves, up to %ld)\n"
+             "turns: %ld\nsensor reads: %ld\ncells visited: %ld\nrobot time: %.1f s\ntime in studentAI: %.3f ms (%.0f ns/call)\n",
+             aiCalls, moves, blocked, crowdedTicks, extraMoves, maxTickMoves, turns, sensors, cellsVisited, runTime / 1000.0, aiNs / 1e6,
+             aiCalls ? (double)aiNs / aiCalls : 0.0);
+    std::string out = text;
+    for(int i = 0; i < STATS_BUCKETS; i++)
+    {
+        if(histogram[i])
+        {
+            snprintf(text, sizeof(text), "  %s %s: %ld\n", i == STATS_BUCKETS - 1 ? ">" : "<",
+                     bucketLimit(i == STATS_BUCKETS - 1 ? i - 1 : i).c_str(), histogram[i]);
+            out += text;
+        }
+    }
+    return out;
+}
+
+void writeStatsCsvHeader(FILE *file)
+{
+    fprintf(file, "maze,ai_calls,moves,blocked,crowded_ticks,extra_moves,max_tick_moves,turns,sensors,cells_visited,robot_ms,ai_ns");
+    for(int i = 0; i < STATS_BUCKETS - 1; i++)
+    {
+        fprintf(file, ",lt_2^%d_ns", i);
+    }
+    fprintf(file, ",ge_2^%d_ns\n", STATS_BUCKETS - 2);
+}
+
+void writeStatsCsv(FILE *file, const char *name, const runStats &stats)
+{
+    fprintf(file, "%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%llu", name, stats.aiCalls, stats.moves, stats.blocked,
+            stats.crowdedTicks, stats.extraMoves, stats.maxTickMoves, stats.turns, stats.sensors, stats.cellsVisited,
+            stats.runTime, (unsigned long long)stats.aiNs);
+    for(int i = 0; i < STATS_BUCKETS; i++)
+    {
+        fprintf(file, ",%ld", stats.histogram[i]);
+    }
+    fprintf(file, "\n");
+}
+
+void writeStatsJson(FILE *file, const char *name, const runStats &stats)
+{
+    fprintf(file, "{\"maze\": \"");
+    for(const char *c = name; *c; c++)
+    {
+        if(*c == '"' || *c == '\\') fputc('\\', file);
+        fputc(*c, file);
+    }
+    fprintf(file, "\", \"ai_calls\": %ld, \"moves\": %ld, \"blocked\": %ld, \"crowded_ticks\": %ld, \"extra_moves\": %ld, "
+                  "\"max_tick_moves\": %ld, \"turns\": %ld, \"sensors\": %ld, \"cells_visited\": %ld, \"robot_ms\": %ld, "
+                  "\"ai_ns\": %llu, \"histogram_ns\": [",
+            stats.aiCalls, stats.moves, stats.blocked, stats.crowdedTicks, stats.extraMoves, stats.maxTickMoves,
+            stats.turns, stats.sensors, stats.cellsVisited, stats.runTime, (unsigned long long)stats.aiNs);
+    for(int i = 0; i < STATS_BUCKETS; i++)
+    {
+        fprintf(file, "%s%ld", i ? ", " : "", stats.histogram[i]);
+    }
+    fprintf(file, "]}");
+}
+
+mazeError saveRunStats(const char *fileName, const char *name, const runStats &stats)
+{
+    size_t length = strlen(fileName);
+    bool csv = length >= 4 && !strcmp(fileName + length - 4, ".csv");
+    FILE *file = fopen(fileName, csv ? "a" : "w");
+    if(!file)
+    {
+        return MAZE_ERR_OPEN;
+    }
+    if(csv)
+    {
+        fseek(file, 0, SEEK_END);
+        if(ftell(file) == 0)
+        {
+            writeStatsCsvHeader(file);
+        }
+        writeStatsCsv(file, name, stats);
+    }
+    else
+    {
+        writeStatsJson(file, name, stats);
+        fprintf(file, "\n");
+    }
+    return fclose(file) == 0 ? MAZE_OK : MAZE_ERR_OPEN;
+}
@@ -0,0 +1,57 @@
+#ifndef RUNSTATS_H
+#define RUNSTATS_H
+
+#include "mazeIO.h"
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+
+//histogram bucket i counts studentAI() calls that took from 2^(i-1) up to 2^i ns,
+//the last bucket takes everything slower
+#define STATS_BUCKETS 32
+
+//Counters for one run. mazeSim bumps them from the student api, the timing is
+//only taken when the sim has it switched on since a clock read costs more than
+//the rest of a tick's bookkeeping together
+struct runStats
+{
+    runStats() { this->clear(); }
+    void clear();
+
+    void addCall(uint64_t ns)
+    {
+        int bucket = 0;
+        while(ns >> bucket && bucket < STATS_BUCKETS - 1)
+        {
+            bucket++;
+        }
+        histogram[bucket]++;
+        aiNs += ns;
+    }
+
+    long aiCalls;           //studentAI() calls, one per tick
+    long moves;             //moveForward that moved
+    long blocked;           //moveForward into a wall
+    long crowdedTicks;      //studentAI() calls that moved more than once, against the rules
+    long extraMoves;        //moves past the first in those calls, blocked ones too
+    long maxTickMoves;      //most moves in one call
+    long turns;
+    long sensors;
+    long cellsVisited;      //different cells the mouse stood on, the start included
+    long runTime;           //estimated robot time in ms, see motionCost
+    uint64_t aiNs;          //wall time inside studentAI(), 0 without timing
+    long histogram[STATS_BUCKETS];
+
+    //a few lines for the GUI
+    std::string summary() const;
+};
+
+void writeStatsCsvHeader(FILE *file);
+void writeStatsCsv(FILE *file, const char *name, const runStats &stats);
+void writeStatsJson(FILE *file, const char *name, const runStats &stats);
+
+//a .csv file gets a row added, with the header first if the file is new, so runs
+//pile up to compare. Anything else is overwritten with the run as one JSON object
+mazeError saveRunStats(const char *fileName, const char *name, const runStats &stats);
+
+#endif // RUNSTATS_H
@@ -0,0 +1,206 @@
+#include "runTrace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static_assert(sizeof(mtrHeader) == 56, "mtr header layout changed");
+
+runTrace::runTrace()
+{
+    this->begin(baseMap(), dUP);
+}
+
+void runTrace::begin(const baseMap &maze, mDirection dir)
+{
+    _width = maze.width();
+    _height = maze.height();
+    _checksum = ::mazeChecksum(maze);
+    _start.event = 0;
+    _start.ticks = _start.steps = _start.turns = _start.sensors = 0;
+    _start.prints = 0;
+    _start.x = maze.startX();
+    _start.y = maze.startY();
+    _start.dir = dir;
+    _start.finished = false;
+    this->clear();
+}
+
+//drops the events but keeps the maze and start pose
+void runTrace::clear()
+{
+    _events.clear();
+    _count = 0;
+    _last = _start;
+    _keyframes.clear();
+    _strings.clear();
+    _prints.clear();
+    _stringIndex.clear();
+}
+
+void runTrace::recordPrint(const char *mesg)
+{
+    //most AIs print the same few lines over and over, store each one once
+    std::unordered_map<std::string, uint32_t>::iterator found = _stringIndex.find(mesg);
+    if(found == _stringIndex.end())
+    {
+        found = _stringIndex.insert(std::make_pair(std::string(mesg), (uint32_t)_strings.size())).first;
+        _strings.push_back(mesg);
+    }
+    _prints.push_back(found->second);
+    this->record(TRACE_PRINT);
+}
+
+static bool keyframeBefore(long tick, const traceState &keyframe)
+{
+    return tick < keyframe.ticks;
+}
+
+traceState runTrace::seekTick(long tick) const
+{
+    //last keyframe that isn't past the tick, the one before a later keyframe
+    //can still be in the middle of the tick we want so always replay forward
+    std::vector<traceState>::const_iterator next =
+            std::upper_bound(_keyframes.begin(), _keyframes.end(), tick, keyframeBefore);
+    traceState state = next == _keyframes.begin() ? _start : *(next - 1);
+    while(state.event < _count)
+    {
+        traceEvent e = this->event(state.event);
+        if(e == TRACE_TICK && state.ticks >= tick)
+        {
+            break;
+        }
+        this->apply(e, state);
+    }
+    return state;
+}
+
+mazeError runTrace::write(const char *fileName) const
+{
+    FILE *outFile = fopen(fileName, "wb");
+    if(!outFile)
+    {
+        return MAZE_ERR_OPEN;
+    }
+
+    mtrHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MTR_MAGIC, 4);
+    header.version = MTR_VERSION;
+    header.headerSize = sizeof(header);
+    header.byteOrder = MAZB_BYTE_ORDER;
+    header.width = _width;
+    header.height = _height;
+    header.startX = _start.x;
+    header.startY = _start.y;
+    header.startDir = _start.dir;
+    header.mazeChecksum = _checksum;
+    header.events = _count;
+    header.strings = _strings.size();
+    header.prints = _prints.size();
+
+    bool ok = fwrite(&header, sizeof(header), 1, outFile) == 1 &&
+              fwrite(_events.data(), 1, _events.size(), outFile) == _events.size() &&
+              fwrite(_prints.data(), sizeof(uint32_t), _prints.size(), outFile) == _prints.size();
+    for(size_t i = 0; ok && i < _strings.size(); i++)
+    {
+        uint32_t length = _strings[i].size();
+        ok = fwrite(&length, sizeof(length), 1, outFile) == 1 &&
+             fwrite(_strings[i].data(), 1, length, outFile) == length;
+    }
+    return fclose(outFile) == 0 && ok ? MAZE_OK : MAZE_ERR_OPEN;
+}
+
+mazeError runTrace::read(const char *fileName)
+{
+    FILE *inFile = fopen(fileName, "rb");
+    if(!inFile)
+    {
+        return MAZE_ERR_OPEN;
+    }
+
+    fseek(inFile, 0, SEEK_END);
+    long fileSize = ftell(inFile);
+    fseek(inFile, 0, SEEK_SET);
+
+    mtrHeader header;
+    if(fread(&header, sizeof(header), 1, inFile) != 1 || memcmp(header.magic, MTR_MAGIC, 4))
+    {
+        fclose(inFile);
+        return MAZE_ERR_TRACE;
+    }
+    if(header.version != MTR_VERSION || header.byteOrder != MAZB_BYTE_ORDER || header.headerSize != sizeof(header))
+    {
+        fclose(inFile);
+        return MAZE_ERR_VERSION;
+    }
+    if(header.width < 1 || header.width > MAZE_MAX_SIZE || header.height < 1 || header.height > MAZE_MAX_SIZE ||
+       header.startX >= header.width || header.startY >= header.height || header.startDir > dUP ||
+       header.prints > header.events || header.events / 2 > (uint64_t)fileSize)
+    {
+        fclose(inFile);
+        return MAZE_ERR_TRACE;
+    }
+
+    std::vector<uint8_t> events((header.events + 1) / 2);
+    std::vector<uint32_t> prints(header.prints);
+    std::vector<std::string> strings;
+    bool ok = fread(events.data(), 1, events.size(), inFile) == events.size() &&
+              fread(prints.data(), sizeof(uint32_t), prints.size(), inFile) == prints.size();
+    for(uint32_t i = 0; ok && i < header.strings; i++)
+    {
+        uint32_t length;
+        ok = fread(&length, sizeof(length), 1, inFile) == 1 && length <= (uint64_t)fileSize;
+        if(ok)
+        {
+            std::string mesg(length, '\0');
+            ok = fread(&mesg[0], 1, length, inFile) == length;
+            strings.push_back(mesg);
+        }
+    }
+    fclose(inFile);
+    for(size_t i = 0; ok && i < prints.size(); i++)
+    {
+        ok = prints[i] < strings.size();
+    }
+    if(!ok)
+    {
+        return MAZE_ERR_TRACE;
+    }
+
+    //replay the whole run once to check it and to rebuild the keyframes
+    baseMap maze(header.width, header.height);
+    maze.setStart(header.startX, header.startY);
+    this->begin(maze, mDirection(header.startDir));
+    _checksum = header.mazeChecksum;
+    _strings.swap(strings);
+    for(uint64_t i = 0; i < header.events; i++)
+    {
+        traceEvent e = traceEvent((events[i >> 1] >> ((i & 1) * 4)) & 15);
+        if(e > TRACE_SENSE_CELL || (e == TRACE_PRINT && _prints.size() == prints.size()))
+        {
+            this->begin(baseMap(), dUP);
+            return MAZE_ERR_TRACE;
+        }
+        if(e == TRACE_PRINT)
+        {
+            _prints.push_back(prints[_prints.size()]);
+        }
+        this->record(e);
+        //the mouse can't have walked off the maze, the scrubber would draw it there
+        if((unsigned)_last.x >= (unsigned)_width || (unsigned)_last.y >= (unsigned)_height)
+        {
+            this->begin(baseMap(), dUP);
+            return MAZE_ERR_TRACE;
+        }
+    }
+    if(_prints.size() != prints.size())
+    {
+        this->begin(baseMap(), dUP);
+        return MAZE_ERR_TRACE;
+    }
+    for(size_t i = 0; i < _strings.size(); i++)
+    {
+        _stringIndex[_strings[i]] = i;
+    }
+    return MAZE_OK;
+}
@@ -0,0 +1,168 @@
+#ifndef RUNTRACE_H
+#define RUNTRACE_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include "mazeIO.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Everything the AI did during one run, packed 4 bits per event. Moves, turns and
+//sensor reads are enough to rebuild the pose at any point without the maze or the AI.
+//printUI messages are stored once each and referenced by index.
+enum traceEvent
+{
+    TRACE_TICK,
+    TRACE_FORWARD,
+    TRACE_BLOCKED,
+    TRACE_LEFT,
+    TRACE_RIGHT,
+    TRACE_SENSE_LEFT,
+    TRACE_SENSE_LEFT_WALL,
+    TRACE_SENSE_FORWARD,
+    TRACE_SENSE_FORWARD_WALL,
+    TRACE_SENSE_RIGHT,
+    TRACE_SENSE_RIGHT_WALL,
+    TRACE_PRINT,
+    TRACE_FINISH,
+    TRACE_SENSE_CELL        //all four walls read at once. Keep it last, read() rejects anything past it
+};
+
+//mouse and counters after some number of events, cells are 0 based
+struct traceState
+{
+    size_t event;
+    long ticks, steps, turns, sensors;
+    size_t prints;
+    int x, y;
+    mDirection dir;
+    bool finished;
+};
+
+//Run trace file (.mtr), little endian. The header is followed by the packed events,
+//the print list (one string index per printUI) and the strings, each with a uint32 length.
+//Keyframes aren't stored, loading rebuilds them in one pass.
+#define MTR_MAGIC "MTRC"
+#define MTR_VERSION 1
+
+struct mtrHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t byteOrder;
+    uint32_t width;
+    uint32_t height;
+    uint32_t startX, startY;
+    uint32_t startDir;
+    uint64_t mazeChecksum;
+    uint64_t events;
+    uint32_t strings;
+    uint32_t prints;
+};
+
+//a keyframe is kept every this many events, seeking replays at most this many
+#define TRACE_KEYFRAME_EVENTS 1024
+
+class runTrace
+{
+public:
+    runTrace();
+
+    //starts a new recording on the given maze from its start cell
+    void begin(const baseMap &maze, mDirection dir);
+    void clear();
+
+    void record(traceEvent event)
+    {
+        if(_count % TRACE_KEYFRAME_EVENTS == 0)
+        {
+            _keyframes.push_back(_last);
+        }
+        if(_count % 2 == 0)
+        {
+            _events.push_back(event);
+        }
+        else
+        {
+            _events.back() |= event << 4;
+        }
+        _count++;
+        apply(event, _last);
+    }
+    void recordPrint(const char *mesg);
+
+    traceEvent event(size_t i) const { return traceEvent((_events[i >> 1] >> ((i & 1) * 4)) & 15); }
+    size_t eventCount() const { return _count; }
+    long tickCount() const { return _last.ticks; }
+    const traceState &lastState() const { return _last; }
+    const traceState &startState() const { return _start; }
+    int mazeWidth() const { return _width; }
+    int mazeHeight() const { return _height; }
+    uint64_t mazeChecksum() const { return _checksum; }
+
+    //message for the n'th printUI of the run
+    const std::string &print(size_t n) const { return _strings[_prints[n]]; }
+
+    //state at the end of the given tick, a binary search over the keyframes
+    //and then at most TRACE_KEYFRAME_EVENTS events
+    traceState seekTick(long tick) const;
+    inline void apply(traceEvent event, traceState &state) const;
+
+    mazeError write(const char *fileName) const;
+    mazeError read(const char *fileName);
+
+private:
+    int _width, _height;
+    uint64_t _checksum;
+    std::vector<uint8_t> _events;
+    size_t _count;
+    traceState _start, _last;
+    std::vector<traceState> _keyframes;
+    std::vector<std::string> _strings;
+    std::vector<uint32_t> _prints;
+    std::unordered_map<std::string, uint32_t> _stringIndex;
+};
+
+void runTrace::apply(traceEvent event, traceState &state) const
+{
+    //same direction order as mazeSim, right turn is +1
+    static const int dx[4] = {1, 0, -1, 0};
+    static const int dy[4] = {0, -1, 0, 1};
+    state.event++;
+    switch(event)
+    {
+    case TRACE_TICK:
+        state.ticks++;
+        break;
+    case TRACE_FORWARD:
+        state.x += dx[state.dir];
+        state.y += dy[state.dir];
+        state.steps++;
+        break;
+    case TRACE_LEFT:
+        state.dir = mDirection((state.dir + 3) & 3);
+        state.turns++;
+        break;
+    case TRACE_RIGHT:
+        state.dir = mDirection((state.dir + 1) & 3);
+        state.turns++;
+        break;
+    case TRACE_PRINT:
+        state.prints++;
+        break;
+    case TRACE_FINISH:
+        state.finished = true;
+        break;
+    case TRACE_BLOCKED:
+        break;
+    default:
+        state.sensors++;
+        break;
+    }
+}
+
+#endif // RUNTRACE_H
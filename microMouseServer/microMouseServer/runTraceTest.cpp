@@ -0,0 +1,124 @@
+//runTraceTest - records runs of the shipped solvers, writes them as .mtr files and
+//reads them back, and checks that a trace walking off its maze is refused. Exits
+//with 1 if any trace doesn't come back the way it went out
+//
+//usage: runTraceTest [--tmp dir] [maze file]...    t1.maz when no maze is given
+
+#include "mazeSim.h"
+#include "mazeSolver.h"
+#include "runTrace.h"
+#include "nullBuffer.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static bool sameState(const traceState &a, const traceState &b)
+{
+    return a.event == b.event && a.ticks == b.ticks && a.steps == b.steps && a.turns == b.turns &&
+           a.sensors == b.sensors && a.prints == b.prints && a.x == b.x && a.y == b.y && a.dir == b.dir &&
+           a.finished == b.finished;
+}
+
+//one solver on one maze, recorded, written, read and compared event by event
+static bool roundTrip(const std::string &mazeFile, const solverEntry &entry, const std::string &traceFile)
+{
+    mazeSim sim;
+    runTrace recorded;
+    std::unique_ptr<mazeSolver> solver(entry.create());
+    mazeError err = readMaze(mazeFile.c_str(), sim.mazeData);
+    if(err != MAZE_OK)
+    {
+        printf("FAIL %s: %s\n", mazeFile.c_str(), mazeErrorString(err));
+        return false;
+    }
+    sim.setSolver(solver.get());
+    sim.setTrace(&recorded);
+    sim.mazeChanged();
+    sim.resetMouse();
+    sim.run(100000);
+
+    //the whole point is a run that read whole cells, senseWalls() is its own event
+    bool sensedCell = false;
+    for(size_t i = 0; i < recorded.eventCount(); i++)
+    {
+        sensedCell |= recorded.event(i) == TRACE_SENSE_CELL;
+    }
+
+    runTrace loaded;
+    mazeError wrote = recorded.write(traceFile.c_str());
+    mazeError read = wrote == MAZE_OK ? loaded.read(traceFile.c_str()) : wrote;
+    remove(traceFile.c_str());
+    bool ok = read == MAZE_OK && loaded.eventCount() == recorded.eventCount() &&
+              loaded.mazeChecksum() == recorded.mazeChecksum() && sameState(loaded.lastState(), recorded.lastState());
+    for(size_t i = 0; ok && i < recorded.eventCount(); i++)
+    {
+        ok = loaded.event(i) == recorded.event(i);
+    }
+    for(long t = 0; ok && t <= recorded.tickCount(); t += 7)
+    {
+        ok = sameState(loaded.seekTick(t), recorded.seekTick(t));
+    }
+
+    printf("%s %-12s %-24s %8zu events%s%s\n", ok ? "ok  " : "FAIL", entry.name.c_str(), mazeFile.c_str(), recorded.eventCount(),
+           sensedCell ? ", senseWalls" : "", read != MAZE_OK ? (std::string(", ") + mazeErrorString(read)).c_str() : "");
+    return ok;
+}
+
+//a hand made trace that walks up out of a 1x2 maze has to be refused
+static bool offMazeRejected(const std::string &traceFile)
+{
+    baseMap maze(1, 2);
+    runTrace walked, loaded;
+    walked.begin(maze, dUP);
+    walked.record(TRACE_TICK);
+    walked.record(TRACE_FORWARD);
+    walked.record(TRACE_TICK);
+    walked.record(TRACE_FORWARD);
+    mazeError wrote = walked.write(traceFile.c_str());
+    mazeError read = wrote == MAZE_OK ? loaded.read(traceFile.c_str()) : wrote;
+    remove(traceFile.c_str());
+    bool ok = read == MAZE_ERR_TRACE && loaded.eventCount() == 0;
+    printf("%s %-37s %s\n", ok ? "ok  " : "FAIL", "trace leaving the maze", mazeErrorString(read));
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string tmp = "/tmp";
+    std::vector<std::string> files;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--tmp") && i + 1 < argc)
+        {
+            tmp = argv[++i];
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+    if(files.empty())
+    {
+        files.push_back("t1.maz");
+    }
+
+    //the AI's debug output isn't what is being tested
+    nullBuffer discard;
+    std::streambuf *coutBuffer = std::cout.rdbuf(&discard);
+    int failed = 0;
+    std::vector<solverEntry> &solvers = solverRegistry();
+    for(size_t f = 0; f < files.size(); f++)
+    {
+        for(size_t s = 0; s < solvers.size(); s++)
+        {
+            failed += !roundTrip(files[f], solvers[s], tmp + "/runTraceTest.mtr");
+        }
+    }
+    std::cout.rdbuf(coutBuffer);
+    failed += !offMazeRejected(tmp + "/runTraceTest.mtr");
+    printf("%d failed\n", failed);
+    return failed ? 1 : 0;
+}
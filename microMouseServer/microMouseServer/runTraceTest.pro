@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Run trace round trip test, builds next to microMouseServer.pro
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console thread
+CONFIG   -= app_bundle qt
+
+TARGET = runTraceTest
+TEMPLATE = app
+
+include(simCore.pri)
+
+SOURCES += runTraceTest.cpp
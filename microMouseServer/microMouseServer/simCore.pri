@@ -0,0 +1,55 @@
+# Qt free simulation core shared by the GUI and the headless tools
+
+CONFIG += thread
+# coroutineSolver.h wants C++20, compilers without it still build the rest
+CONFIG += c++2a
+# solver plugins are opened with dlopen
+unix: LIBS += -ldl
+
+SOURCES += $$PWD/mazeBase.cpp \
+    $$PWD/mazeEditor.cpp \
+    $$PWD/mazeSim.cpp \
+    $$PWD/mazeSolver.cpp \
+    $$PWD/solverPlugin.cpp \
+    $$PWD/coroutineSolver.cpp \
+    $$PWD/mazeIO.cpp \
+    $$PWD/mazeParser.cpp \
+    $$PWD/mazeGenerator.cpp \
+    $$PWD/mazeAnalysis.cpp \
+    $$PWD/mazeGrader.cpp \
+    $$PWD/floodPlanner.cpp \
+    $$PWD/floodSolver.cpp \
+    $$PWD/nodeGraph.cpp \
+    $$PWD/pathSearch.cpp \
+    $$PWD/routePlanner.cpp \
+    $$PWD/runTrace.cpp \
+    $$PWD/runStats.cpp \
+    $$PWD/robotLink.cpp \
+    $$PWD/simRunner.cpp \
+    $$PWD/studentai.cpp
+
+HEADERS += $$PWD/mazeConst.h \
+    $$PWD/mazeBase.h \
+    $$PWD/mazeEditor.h \
+    $$PWD/mazeSim.h \
+    $$PWD/mazeSolver.h \
+    $$PWD/solverPlugin.h \
+    $$PWD/solverPluginApi.h \
+    $$PWD/coroutineSolver.h \
+    $$PWD/mazeIO.h \
+    $$PWD/mazeParser.h \
+    $$PWD/mazeGenerator.h \
+    $$PWD/mazeAnalysis.h \
+    $$PWD/mazeGrader.h \
+    $$PWD/floodPlanner.h \
+    $$PWD/floodSolver.h \
+    $$PWD/nodeGraph.h \
+    $$PWD/pathSearch.h \
+    $$PWD/routePlanner.h \
+    $$PWD/runTrace.h \
+    $$PWD/runStats.h \
+    $$PWD/robotLink.h \
+    $$PWD/simRunner.h \
+    $$PWD/spscRing.h \
+    $$PWD/nullBuffer.h \
+    $$PWD/studentai.h
@@ -0,0 +1,208 @@
+#include "simRunner.h"
+#include "robotLink.h"
+#include <chrono>
+
+simRunner::simRunner(mazeSim *sim)
+{
+    _sim = sim;
+    _robot = NULL;
+    _stop = false;
+    _speed = 1;
+    _view.x = _view.y = 0;
+    _view.dir = dUP;
+    _view.ticks = 0;
+    _sim->setListener(this);
+}
+
+simRunner::~simRunner()
+{
+    this->stop();
+}
+
+void simRunner::setRobot(const robotLink *robot)
+{
+    _robot = robot;
+}
+
+void simRunner::start(double speed)
+{
+    this->stop();
+    //whatever a stopped run left behind is stale now
+    simEvent event;
+    while(_ring.pop(event))
+    {
+    }
+
+    _view.x = _event.x = _sim->mouseX();
+    _view.y = _event.y = _sim->mouseY();
+    _view.dir = _event.dir = _sim->mouseDir();
+    _view.ticks = _sim->tickCount();
+    _view.stats = _sim->stats();
+    _view.link = simLinkStats();
+    _stop = false;
+    _speed = speed;
+    _thread = std::thread(&simRunner::work, this);
+}
+
+void simRunner::setSpeed(double speed)
+{
+    _speed = speed;
+}
+
+void simRunner::stop()
+{
+    if(_thread.joinable())
+    {
+        _stop = true;
+        _thread.join();
+    }
+}
+
+bool simRunner::isRunning() const
+{
+    return _thread.joinable();
+}
+
+int simRunner::poll(simListener *listener)
+{
+    int count = 0;
+    simEvent event;
+    while(_ring.pop(event))
+    {
+        count++;
+        switch(event.type)
+        {
+        case SIM_POSE:
+            _view.x = event.x;
+            _view.y = event.y;
+            _view.dir = event.dir;
+            _view.ticks = event.ticks;
+            break;
+        case SIM_PRINT:
+            if(listener) listener->simPrint(event.text.c_str());
+            break;
+        case SIM_STATS:
+            _view.stats = event.stats;
+            _view.link = event.link;
+            break;
+        case SIM_FINISHED:
+            //the worker has nothing left to do once this is in the ring
+            _thread.join();
+            if(listener) listener->simFinished();
+            return count;
+        }
+    }
+    return count;
+}
+
+//the sim calls these from the worker
+void simRunner::simPrint(const char *mesg)
+{
+    _event.type = SIM_PRINT;
+    _event.text = mesg;
+    this->pushWait(_event);
+}
+
+void simRunner::simFinished()
+{
+    //work() sees isFinished() and sends the last pose and stats before SIM_FINISHED
+}
+
+void simRunner::work()
+{
+    typedef std::chrono::steady_clock clock;
+    clock::time_point next = clock::now(), lastStats = next;
+    double speed = -1;
+
+    while(!_stop.load(std::memory_order_relaxed) && !_sim->isFinished())
+    {
+        _sim->tick();
+        if(_sim->mouseX() != _event.x || _sim->mouseY() != _event.y || _sim->mouseDir() != _event.dir)
+        {
+            this->pushPose(false);
+        }
+
+        clock::time_point now = clock::now();
+        if(now - lastStats >= std::chrono::milliseconds(1000/FRAME_RATE))
+        {
+            this->pushStats(false);
+            lastStats = now;
+        }
+
+        //a new speed starts its schedule from now rather than catching up
+        double want = _speed.load(std::memory_order_relaxed);
+        if(want != speed)
+        {
+            speed = want;
+            next = now;
+        }
+        if(speed > 0)
+        {
+            next += std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(MDELAY / speed));
+            //a tick that ran long (a slow AI, a real mouse) pushes the rest back, no burst after it
+            if(next < now)
+            {
+                next = now;
+            }
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    this->pushPose(true);
+    this->pushStats(true);
+    if(_sim->isFinished())
+    {
+        _event.type = SIM_FINISHED;
+        this->pushWait(_event);
+    }
+}
+
+void simRunner::pushPose(bool wait)
+{
+    _event.type = SIM_POSE;
+    _event.x = _sim->mouseX();
+    _event.y = _sim->mouseY();
+    _event.dir = _sim->mouseDir();
+    _event.ticks = _sim->tickCount();
+    if(wait)
+    {
+        this->pushWait(_event);
+        return;
+    }
+    //the GUI is behind, it will draw a newer pose than this one anyway
+    simEvent pose = _event;
+    _ring.push(std::move(pose));
+}
+
+void simRunner::pushStats(bool wait)
+{
+    simEvent event;
+    event.type = SIM_STATS;
+    event.stats = _sim->stats();
+    if(_robot && _robot->isOpen())
+    {
+        event.link.lastRtt = _robot->lastRtt();
+        event.link.averageRtt = _robot->averageRtt();
+        event.link.maxRtt = _robot->maxRtt();
+        event.link.roundTrips = _robot->roundTrips();
+    }
+    if(wait)
+    {
+        this->pushWait(event);
+        return;
+    }
+    _ring.push(std::move(event));
+}
+
+//for events the GUI mustn't miss, gives up only when asked to stop
+void simRunner::pushWait(simEvent &event)
+{
+    while(!_ring.push(std::move(event)))
+    {
+        if(_stop.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
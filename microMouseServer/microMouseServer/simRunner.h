@@ -0,0 +1,97 @@
+#ifndef SIMRUNNER_H
+#define SIMRUNNER_H
+
+#include "mazeSim.h"
+#include "runStats.h"
+#include "spscRing.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+class robotLink;
+
+//ring slots, the worker can get this far ahead of the GUI before poses are dropped
+#define SIM_EVENT_RING 1024
+
+enum simEventType
+{
+    SIM_POSE,           //x, y, dir after a tick that moved or turned the mouse
+    SIM_PRINT,          //text the AI printed
+    SIM_STATS,          //stats and link, about every frame and once more at the end
+    SIM_FINISHED        //the AI called foundFinish, nothing comes after it
+};
+
+//round trips of the mouse link at the time of a SIM_STATS, see robotLink
+struct simLinkStats
+{
+    simLinkStats() : lastRtt(0), averageRtt(0), maxRtt(0), roundTrips(0) {}
+    double lastRtt, averageRtt, maxRtt;
+    long roundTrips;
+};
+
+struct simEvent
+{
+    simEventType type;
+    int x, y;
+    mDirection dir;
+    long ticks;
+    std::string text;
+    runStats stats;
+    simLinkStats link;
+};
+
+//Runs a mazeSim on its own thread so a slow studentAI() never holds up the window.
+//The worker only talks to the GUI through a single producer, single consumer ring,
+//the GUI drains it with poll() once a frame. Poses are dropped when the ring is full
+//since only the newest one gets drawn anyway, prints and the finish wait for room.
+//
+//Nothing else may touch the sim between start() and the run ending, stop() first.
+class simRunner : private simListener
+{
+public:
+    explicit simRunner(mazeSim *sim);
+    ~simRunner();
+
+    //the link to show round trips for while a run owns it, NULL for none
+    void setRobot(const robotLink *robot);
+
+    //speed is a multiple of real time, one tick every MDELAY ms at 1. 0 runs unthrottled
+    void start(double speed);
+    void setSpeed(double speed);
+    //asks the worker to stop after its current tick and waits for it
+    void stop();
+    bool isRunning() const;
+
+    //GUI side. Hands prints and the finish to listener and keeps the newest pose
+    //and stats, returns how many events there were
+    int poll(simListener *listener);
+    int mouseX() const { return _view.x; }
+    int mouseY() const { return _view.y; }
+    mDirection mouseDir() const { return _view.dir; }
+    long tickCount() const { return _view.ticks; }
+    const runStats &stats() const { return _view.stats; }
+    const simLinkStats &linkStats() const { return _view.link; }
+
+private:
+    void simPrint(const char *mesg);
+    void simFinished();
+
+    void work();
+    void pushPose(bool wait);
+    void pushStats(bool wait);
+    void pushWait(simEvent &event);
+
+    mazeSim *_sim;
+    const robotLink *_robot;
+    std::thread _thread;
+    std::atomic<bool> _stop;
+    std::atomic<double> _speed;
+    spscRing<simEvent, SIM_EVENT_RING> _ring;
+
+    //worker side
+    simEvent _event;
+    //GUI side, the newest of everything poll() has seen
+    simEvent _view;
+};
+
+#endif // SIMRUNNER_H
@@ -0,0 +1,232 @@
+#include "solverPlugin.h"
+#include "solverPluginApi.h"
+#include <cstdio>
+#include <cstdlib>
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+//one opened copy of a plugin, closed when the last solver made from it is gone
+struct pluginLibrary
+{
+    void *handle;
+    const solverPluginInfo *info;
+
+    pluginLibrary() : handle(NULL), info(NULL) {}
+    ~pluginLibrary();
+};
+
+//the mazeSolver the sim sees, passes every tick on to the plugin's own object
+class pluginMazeSolver : public mazeSolver
+{
+public:
+    explicit pluginMazeSolver(const std::shared_ptr<pluginLibrary> &library);
+    ~pluginMazeSolver();
+
+protected:
+    void studentAI();
+
+private:
+    static pluginMazeSolver *self(void *mouse) { return static_cast<pluginMazeSolver *>(mouse); }
+    static int isWallLeftCall(void *mouse) { return self(mouse)->isWallLeft(); }
+    static int isWallRightCall(void *mouse) { return self(mouse)->isWallRight(); }
+    static int isWallForwardCall(void *mouse) { return self(mouse)->isWallForward(); }
+    static int moveForwardCall(void *mouse) { return self(mouse)->moveForward(); }
+    static void turnLeftCall(void *mouse) { self(mouse)->turnLeft(); }
+    static void turnRightCall(void *mouse) { self(mouse)->turnRight(); }
+    static int senseWallsCall(void *mouse) { return self(mouse)->senseWalls(); }
+    static int senseWallsRelativeCall(void *mouse) { return self(mouse)->senseWallsRelative(); }
+    static int moveDirectionCall(void *mouse, int dir) { return self(mouse)->moveDirection((mDirection)(dir & 3)); }
+    static void turnToCall(void *mouse, int dir) { self(mouse)->turnTo((mDirection)(dir & 3)); }
+    static void foundFinishCall(void *mouse) { self(mouse)->foundFinish(); }
+    static void printUICall(void *mouse, const char *mesg) { self(mouse)->printUI(mesg); }
+    static int mazeWidthCall(void *mouse) { return self(mouse)->mazeWidth(); }
+    static int mazeHeightCall(void *mouse) { return self(mouse)->mazeHeight(); }
+    static int isNewMazeCall(void *mouse) { return self(mouse)->isNewMaze(); }
+    static int startXCall(void *mouse) { return self(mouse)->startX(); }
+    static int startYCall(void *mouse) { return self(mouse)->startY(); }
+    static int goalXCall(void *mouse) { return self(mouse)->goalX(); }
+    static int goalYCall(void *mouse) { return self(mouse)->goalY(); }
+
+    std::shared_ptr<pluginLibrary> _library;
+    void *_solver;
+    solverPluginApi _api;
+};
+
+pluginMazeSolver::pluginMazeSolver(const std::shared_ptr<pluginLibrary> &library) : _library(library)
+{
+    _api.apiSize = sizeof(_api);
+    _api.mouse = this;
+    _api.isWallLeft = isWallLeftCall;
+    _api.isWallRight = isWallRightCall;
+    _api.isWallForward = isWallForwardCall;
+    _api.moveForward = moveForwardCall;
+    _api.turnLeft = turnLeftCall;
+    _api.turnRight = turnRightCall;
+    _api.senseWalls = senseWallsCall;
+    _api.senseWallsRelative = senseWallsRelativeCall;
+    _api.moveDirection = moveDirectionCall;
+    _api.turnTo = turnToCall;
+    _api.foundFinish = foundFinishCall;
+    _api.printUI = printUICall;
+    _api.mazeWidth = mazeWidthCall;
+    _api.mazeHeight = mazeHeightCall;
+    _api.isNewMaze = isNewMazeCall;
+    _api.startX = startXCall;
+    _api.startY = startYCall;
+    _api.goalX = goalXCall;
+    _api.goalY = goalYCall;
+    _solver = _library->info->create();
+}
+
+pluginMazeSolver::~pluginMazeSolver()
+{
+    _library->info->destroy(_solver);
+}
+
+void pluginMazeSolver::studentAI()
+{
+    _library->info->tick(_solver, &_api);
+}
+
+solverPlugin::solverPlugin()
+{
+}
+
+solverPlugin::~solverPlugin()
+{
+}
+
+bool solverPlugin::isLoaded() const
+{
+    return _library != NULL;
+}
+
+const std::string &solverPlugin::fileName() const
+{
+    return _fileName;
+}
+
+const std::string &solverPlugin::error() const
+{
+    return _error;
+}
+
+const solverEntry &solverPlugin::entry() const
+{
+    return _entry;
+}
+
+mazeError solverPlugin::reload()
+{
+    //load() replaces _fileName, it can't read from it at the same time
+    std::string fileName = _fileName;
+    return this->load(fileName.c_str());
+}
+
+#ifdef _WIN32
+
+pluginLibrary::~pluginLibrary()
+{
+}
+
+mazeError solverPlugin::load(const char *fileName)
+{
+    _error = "solver plugins need dlopen";
+    return MAZE_ERR_PLUGIN;
+}
+
+#else
+
+pluginLibrary::~pluginLibrary()
+{
+    if(handle)
+    {
+        dlclose(handle);
+    }
+}
+
+//dlopen() hands back the library it already has for a name it has seen, and a
+//library rewritten while it is mapped crashes whatever runs it. A private copy
+//that is unlinked once open avoids both
+static bool copyToTemp(const char *fileName, std::string &copyName)
+{
+    FILE *in = fopen(fileName, "rb");
+    if(!in)
+    {
+        return false;
+    }
+    const char *dir = getenv("TMPDIR");
+    copyName = std::string(dir && *dir ? dir : "/tmp") + "/solverPluginXXXXXX";
+    int fd = mkstemp(&copyName[0]);
+    FILE *out = fd < 0 ? NULL : fdopen(fd, "wb");
+    bool ok = out != NULL;
+    char buffer[65536];
+    size_t got;
+    while(ok && (got = fread(buffer, 1, sizeof(buffer), in)) > 0)
+    {
+        ok = fwrite(buffer, 1, got, out) == got;
+    }
+    ok = ok && !ferror(in);
+    fclose(in);
+    if(out)
+    {
+        ok = fclose(out) == 0 && ok;
+    }
+    if(!ok && fd >= 0)
+    {
+        unlink(copyName.c_str());
+    }
+    return ok;
+}
+
+mazeError solverPlugin::load(const char *fileName)
+{
+    _error.clear();
+    std::string copyName;
+    if(!copyToTemp(fileName, copyName))
+    {
+        return MAZE_ERR_OPEN;
+    }
+
+    std::shared_ptr<pluginLibrary> library(new pluginLibrary);
+    library->handle = dlopen(copyName.c_str(), RTLD_NOW | RTLD_LOCAL);
+    unlink(copyName.c_str());
+    if(!library->handle)
+    {
+        _error = dlerror();
+        return MAZE_ERR_PLUGIN;
+    }
+    solverPluginEntryFn entry = (solverPluginEntryFn)dlsym(library->handle, SOLVER_PLUGIN_ENTRY_NAME);
+    if(!entry)
+    {
+        _error = std::string("no ") + SOLVER_PLUGIN_ENTRY_NAME + "() in " + fileName;
+        return MAZE_ERR_PLUGIN;
+    }
+    library->info = entry();
+    if(!library->info)
+    {
+        _error = std::string(SOLVER_PLUGIN_ENTRY_NAME) + "() in " + fileName + " returned nothing";
+        return MAZE_ERR_PLUGIN;
+    }
+    if(library->info->abi != SOLVER_PLUGIN_ABI)
+    {
+        _error = "plugin ABI " + std::to_string(library->info->abi) + ", expected " + std::to_string(SOLVER_PLUGIN_ABI);
+        return MAZE_ERR_PLUGIN_ABI;
+    }
+    if(!library->info->name || !library->info->create || !library->info->destroy || !library->info->tick)
+    {
+        _error = std::string("incomplete solverPluginInfo in ") + fileName;
+        return MAZE_ERR_PLUGIN;
+    }
+
+    //a failed reload leaves the last good library and its file name in place
+    _fileName = fileName;
+    _library = library;
+    _entry.name = library->info->name;
+    _entry.create = [library]() -> mazeSolver * { return new pluginMazeSolver(library); };
+    return MAZE_OK;
+}
+
+#endif
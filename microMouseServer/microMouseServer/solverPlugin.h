@@ -0,0 +1,39 @@
+#ifndef SOLVERPLUGIN_H
+#define SOLVERPLUGIN_H
+
+#include "mazeSolver.h"
+#include "mazeIO.h"
+#include <memory>
+#include <string>
+
+struct pluginLibrary;
+
+//A solver loaded from a shared library built against solverPluginApi.h. The file is
+//copied before it is opened, so it can be rebuilt in place and loaded again while
+//solvers made from the old one are still running: every solver keeps the copy it
+//was made from mapped until it is deleted.
+class solverPlugin
+{
+public:
+    solverPlugin();
+    ~solverPlugin();
+
+    mazeError load(const char *fileName);
+    //the same file again, entry() makes solvers with the new code from then on
+    mazeError reload();
+    bool isLoaded() const;
+    //the file entry() comes from, a failed load() doesn't change it
+    const std::string &fileName() const;
+    //what the loader said when load() failed, empty otherwise
+    const std::string &error() const;
+    //the plugin's solver under the name it gives itself, only while loaded
+    const solverEntry &entry() const;
+
+private:
+    std::string _fileName;
+    std::string _error;
+    std::shared_ptr<pluginLibrary> _library;
+    solverEntry _entry;
+};
+
+#endif // SOLVERPLUGIN_H
@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# Example solver plugin, builds next to microMouseServer.pro. Load the .so from
+# Solver > Load Plugin or pass it to mazeBatch/mazeGrade with --plugin
+#
+#-------------------------------------------------
+
+QT       -= core gui
+# a plugin doesn't include simCore.pri, solverPluginApi.h only needs C++11
+CONFIG   += plugin c++11
+CONFIG   -= qt
+
+TARGET = wallFollower
+TEMPLATE = lib
+
+SOURCES += examplePlugin.cpp
+
+HEADERS += solverPluginApi.h
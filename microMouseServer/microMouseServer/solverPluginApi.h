@@ -0,0 +1,135 @@
+#ifndef SOLVERPLUGINAPI_H
+#define SOLVERPLUGINAPI_H
+
+/*
+ * The C ABI between the simulator and a solver built as a shared library. This is
+ * the only header a plugin needs, see examplePlugin.cpp and solverPlugin.pro.
+ *
+ * A plugin exports one function, SOLVER_PLUGIN_ENTRY, that returns its
+ * solverPluginInfo. The host calls create() for every mouse that runs the solver,
+ * tick() once a tick with the student api of that mouse, and destroy() when the
+ * mouse is done with it. Nothing but these structs crosses the boundary, so a
+ * plugin doesn't depend on how the simulator was compiled.
+ *
+ * SOLVER_PLUGIN_ABI goes up whenever these structs change in a way an older
+ * plugin would get wrong, the host refuses plugins built for another one. New
+ * functions only ever go on the end of solverPluginApi, and apiSize says how much
+ * of it the host filled in.
+ */
+#define SOLVER_PLUGIN_ABI 1
+#define SOLVER_PLUGIN_ENTRY solverPluginEntry
+#define SOLVER_PLUGIN_ENTRY_NAME "solverPluginEntry"
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#define SOLVER_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define SOLVER_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the student api of one mouse, mouse goes back as the first argument of every
+   call. Directions are mDirection: 0 right, 1 down, 2 left, 3 up. Walls are
+   bit (1 << direction) for senseWalls() and relativeWall bits for
+   senseWallsRelative(), see mazeSim.h. Cells are 0 based */
+typedef struct solverPluginApi
+{
+    unsigned int apiSize;
+    void *mouse;
+    int (*isWallLeft)(void *mouse);
+    int (*isWallRight)(void *mouse);
+    int (*isWallForward)(void *mouse);
+    int (*moveForward)(void *mouse);
+    void (*turnLeft)(void *mouse);
+    void (*turnRight)(void *mouse);
+    int (*senseWalls)(void *mouse);
+    int (*senseWallsRelative)(void *mouse);
+    int (*moveDirection)(void *mouse, int dir);
+    void (*turnTo)(void *mouse, int dir);
+    void (*foundFinish)(void *mouse);
+    void (*printUI)(void *mouse, const char *mesg);
+    int (*mazeWidth)(void *mouse);
+    int (*mazeHeight)(void *mouse);
+    int (*isNewMaze)(void *mouse);
+    int (*startX)(void *mouse);
+    int (*startY)(void *mouse);
+    int (*goalX)(void *mouse);
+    int (*goalY)(void *mouse);
+} solverPluginApi;
+
+/* true if the host filled in member, older hosts stop short of the newer calls */
+#define SOLVER_PLUGIN_HAS(api, member) \
+    ((api)->apiSize >= offsetof(solverPluginApi, member) + sizeof((api)->member))
+
+typedef struct solverPluginInfo
+{
+    unsigned int abi;               /* SOLVER_PLUGIN_ABI */
+    const char *name;               /* what the tools list it as */
+    void *(*create)(void);
+    void (*destroy)(void *solver);
+    void (*tick)(void *solver, const solverPluginApi *api);
+} solverPluginInfo;
+
+typedef const solverPluginInfo *(*solverPluginEntryFn)(void);
+
+#ifdef __cplusplus
+}
+
+//For C++ plugins: derive from pluginSolver, write studentAI() with the usual api and
+//put SOLVER_PLUGIN(name, class) in one .cpp. The object lives as long as the mouse
+//runs it, so the AI's memory goes in members just like a mazeSolver's
+class pluginSolver
+{
+public:
+    virtual ~pluginSolver() {}
+
+    void tick(const solverPluginApi *api)
+    {
+        _api = api;
+        this->studentAI();
+    }
+
+protected:
+    virtual void studentAI() = 0;
+
+    bool isWallLeft() { return _api->isWallLeft(_api->mouse) != 0; }
+    bool isWallRight() { return _api->isWallRight(_api->mouse) != 0; }
+    bool isWallForward() { return _api->isWallForward(_api->mouse) != 0; }
+    bool moveForward() { return _api->moveForward(_api->mouse) != 0; }
+    void turnLeft() { _api->turnLeft(_api->mouse); }
+    void turnRight() { _api->turnRight(_api->mouse); }
+    int senseWalls() { return _api->senseWalls(_api->mouse); }
+    int senseWallsRelative() { return _api->senseWallsRelative(_api->mouse); }
+    bool moveDirection(int dir) { return _api->moveDirection(_api->mouse, dir) != 0; }
+    void turnTo(int dir) { _api->turnTo(_api->mouse, dir); }
+    void foundFinish() { _api->foundFinish(_api->mouse); }
+    void printUI(const char *mesg) { _api->printUI(_api->mouse, mesg); }
+    int mazeWidth() { return _api->mazeWidth(_api->mouse); }
+    int mazeHeight() { return _api->mazeHeight(_api->mouse); }
+    bool isNewMaze() { return _api->isNewMaze(_api->mouse) != 0; }
+    //a host from before these calls has every maze start at 0,0 and end at 11,7
+    int startX() { return SOLVER_PLUGIN_HAS(_api, startX) ? _api->startX(_api->mouse) : 0; }
+    int startY() { return SOLVER_PLUGIN_HAS(_api, startY) ? _api->startY(_api->mouse) : 0; }
+    int goalX() { return SOLVER_PLUGIN_HAS(_api, goalX) ? _api->goalX(_api->mouse) : 11; }
+    int goalY() { return SOLVER_PLUGIN_HAS(_api, goalY) ? _api->goalY(_api->mouse) : 7; }
+
+private:
+    const solverPluginApi *_api;
+};
+
+#define SOLVER_PLUGIN(pluginName, solverClass) \
+    static void *solverPluginCreate() { return static_cast<pluginSolver *>(new solverClass); } \
+    static void solverPluginDestroy(void *solver) { delete static_cast<pluginSolver *>(solver); } \
+    static void solverPluginTick(void *solver, const solverPluginApi *api) { static_cast<pluginSolver *>(solver)->tick(api); } \
+    extern "C" SOLVER_PLUGIN_EXPORT const solverPluginInfo *SOLVER_PLUGIN_ENTRY() \
+    { \
+        static const solverPluginInfo info = {SOLVER_PLUGIN_ABI, pluginName, solverPluginCreate, solverPluginDestroy, solverPluginTick}; \
+        return &info; \
+    }
+#endif
+
+#endif // SOLVERPLUGINAPI_H
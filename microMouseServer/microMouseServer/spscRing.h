@@ -0,0 +1,56 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+
+//Lock free queue for exactly one producer thread and one consumer thread. Size
+//must be a power of two. Each index is only written by its own side, so a push
+//and a pop never wait on each other. The two indices sit on separate cache lines
+//so the threads don't keep stealing the line from each other.
+template <typename T, size_t Size>
+class spscRing
+{
+    static_assert((Size & (Size - 1)) == 0, "spscRing size must be a power of two");
+
+public:
+    spscRing() : _head(0), _tail(0) {}
+
+    //producer side, false when the ring is full and item wasn't taken
+    bool push(T &&item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if(tail - _head.load(std::memory_order_acquire) == Size)
+        {
+            return false;
+        }
+        _slots[tail & (Size - 1)] = std::move(item);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //consumer side, false when there is nothing to take
+    bool pop(T &item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if(head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = std::move(_slots[head & (Size - 1)]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //either side, only a hint while the other one is running
+    size_t size() const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+    bool full() const { return this->size() == Size; }
+
+private:
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+    alignas(64) T _slots[Size];
+};
+
+#endif // SPSCRING_H
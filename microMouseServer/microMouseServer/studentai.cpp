@@ -1,14 +1,14 @@
-#include "micromouseserver.h"
+#include "studentai.h"
 #include <iostream>
-#include <stack>
-#include <map>
 #include <cstring>
+#include <climits>
 #include <algorithm>
 #include <iomanip>
-#include <queue>
+#include <vector>
 
-// cardinal directions
-enum Dir { N = 0b0001, E = 0b0010, W = 0b0100, S = 0b1000 };
+// cardinal directions, see studentai.h
+typedef studentSolver::Dir Dir;
+const Dir N = studentSolver::N, E = studentSolver::E, W = studentSolver::W, S = studentSolver::S;
 
 Dir opposite(Dir d) {
     switch (d) {
@@ -23,92 +23,82 @@ Dir opposite(Dir d) {
     }
 }
 
-struct Node;
-
-// I didn't want to use std::pair because pair.first isn't as intuitive as Pair.node
-struct Pair {
-    Node *node;
-    int d;
-};
-
-// a node is any tile with more than 2 exit paths, with the exception of the root node (origin) and destination node
-struct Node {
-    int i, x, y;
-    std::map<Dir, Pair> adj;                // maps the 4 directions to either a node and the distance to that node, or &DEAD_END
-    int d = INT_MAX;                        // shortest distance from origin
-    Node *prev;                             // the previous node that minimizes its distance from the origin - these pointers form the optimal node chain
-    Node (int i, int x, int y) : i(i), x(x), y(y) {}
-};
+// the graph keeps 4 adjacency slots per node, slot i is Dir(1 << i)
+int slot(Dir d) {
+    switch (d) {
+    case N:
+        return 0;
+    case E:
+        return 1;
+    case W:
+        return 2;
+    case S:
+        return 3;
+    }
+    return 0;
+}
 
-void microMouseServer::studentAI() {
-    // origin coordinates
-    static int OX = 0;
-    static int OY = 0;
+// the sim's heading for a Dir
+mDirection heading(Dir d) {
+    switch (d) {
+    case N:
+        return dUP;
+    case E:
+        return dRIGHT;
+    case W:
+        return dLEFT;
+    case S:
+        return dDOWN;
+    }
+    return dUP;
+}
 
-    // destination coordinates
-    static int DX = 11;
-    static int DY = 7;
+// senseWalls() gives a wall bit per mDirection, this turns it into open Dir bits
+const int openDirs[16] = {15, 13, 7, 5, 11, 9, 3, 1, 14, 12, 6, 4, 10, 8, 2, 0};
 
-    static bool newRun = true;              // state boolean that resets every time you hit "Start Run"
-    static bool firstRun = true;            // resets every time you change map - indicate map change by enclosing the starting tile in walls and hitting "Start Run"
-    static bool graphBuilding = true;       // if the mouse is currently exploring all nodes to build the node graph
+// a node is any tile with more than 2 exit paths, with the exception of the root node (origin) and destination node
+// nodes are indices into graph, see nodeGraph.h. adj[] holds a node, nodeGraph::DEAD_END or nodeGraph::NONE if not explored yet
+// d is the shortest distance from origin and prev is the node before it - these form the optimal node chain
+const int DEAD_END = nodeGraph::DEAD_END;
+const int NONE = nodeGraph::NONE;
 
-    static int x, y, nodeNum;               // x, y are updated every step; nodeNum is just a counter to identify each node when I print them later
-    static Dir lastStep;                    // always updated to be the same direction as the step we just took
+studentSolver::studentSolver()
+    : OX(0), OY(0), DX(11), DY(7), newRun(true), firstRun(true), graphBuilding(true), x(0), y(0), lastStep(N), rootNode(0) {
+}
 
-    static Node DEAD_END(-1, -1, -1);
-    static Node *map[20][20];               // map[x][y] will give us a pointer to an existing node or a false pointer
-    static std::stack<Dir> s;               // use this stack for backtracking
-    static Node *rootNode;
-    static std::stack<Dir> optimalPath;
-    static std::stack<Dir> pathCopy;
+void studentSolver::studentAI() {
+    // a freshly loaded maze starts over just like the 1x1 cell reset below
+    if (isNewMaze()) {
+        newRun = true;
+        firstRun = true;
+        graphBuilding = true;
+        s = std::stack<Dir>();
+    }
 
     // sets a bit for open directions and clears a bit for blocked directions
     // thus, you can & the return with any Dir and see if that direction is open
-    static auto test = [&]() -> int {
-        int r = isWallForward() + isWallRight() * 2 + isWallLeft() * 4;
-        turnRight();
-        r += isWallRight() * 8;
-        turnLeft();
-        r ^= 0b1111;
-        return r;
+    auto test = [&]() -> int {
+        return openDirs[senseWalls()];
     };
 
     // take a step in the specified cardinal direction
-    static auto step = [&](Dir d) {
+    auto step = [&](Dir d) {
         lastStep = d;
-        switch (d) {
-        case N:
-            y += moveForward();
-            break;
-        case E:
-            turnRight();
-            x += moveForward();
-            turnLeft();
-            break;
-        case W:
-            turnLeft();
-            x -= moveForward();
-            turnRight();
-            break;
-        case S:
-            turnRight();
-            turnRight();
-            y -= moveForward();
-            turnRight();
-            turnRight();
+        if (moveDirection(heading(d))) {
+            x += (d == E) - (d == W);
+            y += (d == N) - (d == S);
         }
     };
 
     // travel from a node in the specified direction and stops at either a node or a dead end
     // returns the number of steps taken to reach that node (or 0 for dead end)
-    static auto travel = [&](Dir d) -> int {
+    auto travel = [&](Dir d) -> int {
         Dir nextDir = d;
         int steps = 0;
         while (true) {
             step(nextDir);
             steps++;
-            if (map[x][y] == rootNode || (x == DX && y == DY)) {               // even though rootNode/destNode might not have 3 open paths, it's still a node
+            if (graph.nodeAt(x, y) == rootNode || (x == DX && y == DY)) {               // even though rootNode/destNode might not have 3 open paths, it's still a node
                 return steps;
             }
             int paths = test();
@@ -129,6 +119,12 @@ void microMouseServer::studentAI() {
     };
 
     if (newRun) {
+        if (firstRun) {                 // every map starts and ends where it says
+            OX = startX();
+            OY = startY();
+            DX = goalX();
+            DY = goalY();
+        }
         x = OX;
         y = OY;
         if (test() == 0) {              // resets firstRun if trapped in a 1x1 cell
@@ -139,11 +135,14 @@ void microMouseServer::studentAI() {
             return;
         }
         if (firstRun) {
-            nodeNum = 0;
-            memset(map, 0, 400 * sizeof(Node *));
-            map[OX][OY] = new Node(nodeNum++, OX, OY);
-            rootNode = map[OX][OY];
-            rootNode->d = 0;
+            if (DX >= mazeWidth() || DY >= mazeHeight()) {
+                printUI("Destination is outside the maze.");
+                foundFinish();
+                return;
+            }
+            graph.reset(mazeWidth(), mazeHeight());         // drops the old graph without freeing anything
+            rootNode = graph.addNode(OX, OY);             // node ids count up from 0 so I can identify them when I print them later
+            graph[rootNode].d = 0;
             optimalPath = std::stack<Dir>();                // clear optimalPath
         }
         pathCopy = optimalPath;
@@ -153,23 +152,24 @@ void microMouseServer::studentAI() {
     if (firstRun) {
         if (graphBuilding) {
             // explore all nodes
-            Node *currentNode = map[x][y];
+            int currentNode = graph.nodeAt(x, y);
             int paths = test();
             for (int i = 0; i < 4; i++) {
                 Dir d = Dir(1 << i);
                 if (paths & d) {
-                    if (!currentNode->adj[d].node) {
+                    if (graph[currentNode].adj[i] == NONE) {
                         int t = travel(d);              // t contains the distance we just travelled
                         if (t) {
-                            if (map[x][y]) {
+                            int there = graph.nodeAt(x, y);
+                            if (there != NONE) {
                                 // exchanges info between the two nodes
-                                map[x][y]->adj[opposite(lastStep)] = {currentNode, t};
-                                currentNode->adj[d] = {map[x][y], t};
+                                graph.link(there, slot(opposite(lastStep)), currentNode, t);
+                                graph.link(currentNode, i, there, t);
                                 travel(opposite(lastStep));
                             } else {
-                                map[x][y] = new Node(nodeNum++, x, y);
-                                map[x][y]->adj[opposite(lastStep)] = {currentNode, t};
-                                currentNode->adj[d] = {map[x][y], t};
+                                there = graph.addNode(x, y);
+                                graph.link(there, slot(opposite(lastStep)), currentNode, t);
+                                graph.link(currentNode, i, there, t);
                                 // push opposite of last step so we can backtrack later
                                 s.push(opposite(lastStep));
                                 // skip the rest of the code and iterate again for the new node
@@ -178,11 +178,11 @@ void microMouseServer::studentAI() {
                         } else {
                             // retreat since we hit a dead end
                             travel(opposite(lastStep));
-                            currentNode->adj[d] = {&DEAD_END, 0};
+                            graph.link(currentNode, i, DEAD_END, 0);
                         }
                     }
                 } else {
-                    currentNode->adj[d] = {&DEAD_END, 0};
+                    graph.link(currentNode, i, DEAD_END, 0);
                 }
             }
 
@@ -196,21 +196,22 @@ void microMouseServer::studentAI() {
                 // a node with 3 dead ends is effectively a dead end itself
                 int deadEnds = 0;
                 for (int i = 0; i < 4; i++) {
-                    deadEnds += currentNode->adj[Dir(1 << i)].node == &DEAD_END;
+                    deadEnds += graph[currentNode].adj[i] == DEAD_END;
                 }
                 // the destination tile is always a node, even if it has 3 dead ends
-                if (deadEnds == 3 && currentNode != map[DX][DY]) {
-                    map[currentNode->x][currentNode->y] = &DEAD_END;
-                    map[x][y]->adj[opposite(lastStep)] = {&DEAD_END, 0};
+                if (deadEnds == 3 && currentNode != graph.nodeAt(DX, DY)) {
+                    graph.setNodeAt(graph[currentNode].x, graph[currentNode].y, DEAD_END);
+                    graph.link(graph.nodeAt(x, y), slot(opposite(lastStep)), DEAD_END, 0);
                 }
             }
         } else {
             // prints node map
             std::cout << std::endl;
-            for (int i = 0; i < 20; i++) {
-                for (int j = 0; j < 20; j++) {
-                    if (map[j][19 - i] && map[j][19 - i] != &DEAD_END)
-                        std::cout << std::setw(3) << map[j][19 - i]->i;
+            for (int i = 0; i < mazeHeight(); i++) {
+                for (int j = 0; j < mazeWidth(); j++) {
+                    int n = graph.nodeAt(j, mazeHeight() - 1 - i);
+                    if (n >= 0)
+                        std::cout << std::setw(3) << graph[n].id;
                     else
                         std::cout << "  .";
                 }
@@ -218,49 +219,25 @@ void microMouseServer::studentAI() {
             }
 
             // calculate optimal path
-            std::queue<Node *> q;               // a node queue for our breadth-first-search approach to traversing the graph
-            q.push(rootNode);
-            bool visited[20][20];               // visited[x][y] tells us if we have already calculated the node at x, y
-            memset(visited, false, 400 * sizeof(bool));
-            visited[rootNode->x][rootNode->y] = true;
-
-            // traverses the node graph breadth-first (i.e. look at all neighbors first before moving on to neighbors' neighbors)
-            while (q.size() > 0) {
-                Node *currentNode = q.front();
-                for (int i = 0; i < 4; i++) {
-                    Pair p = currentNode->adj[Dir(1 << i)];
-                    if (p.node != &DEAD_END) {
-                        // updates best distance and prev node if the path from currentNode is shorter
-                        if (currentNode->d + p.d < p.node->d) {
-                            p.node->d = currentNode->d + p.d;
-                            p.node->prev = currentNode;
-                            q.push(p.node);             // fixes the problem of not updating nodes when a better path is found, because the algo will check any updated nodes again
-                        }
-                        if (!visited[p.node->x][p.node->y]) {
-                            q.push(p.node);
-                            visited[p.node->x][p.node->y] = true;
-                        }
-                    }
-                }
-                q.pop();
+            // A* over the node graph, each node is taken off the heap once with its final distance
+            int n = graph.nodeAt(DX, DY);
+            if (n >= 0 && search.run(graph, rootNode, n) < 0)
+                n = NONE;
+            if (n < 0) {
+                // exploration never reached the destination, so there is no path to follow
+                printUI("Destination not reachable.");
+                graphBuilding = true;
+                newRun = true;
+                foundFinish();
+                return;
             }
-
-            Node *n = map[DX][DY];
             // follows prev node chain from destination back to origin, and builds a direction stack
-            std::cout << std::endl << "Optimal path (total " << n->d << "):" << std::endl;
+            std::cout << std::endl << "Optimal path (total " << graph[n].d << "):" << std::endl;
             while (n != rootNode) {
-                std::cout << n->i << "<-" << n->prev->i << " (" << (n->d - n->prev->d) << ")" << std::endl;
-                int min = INT_MAX;
-                Dir d = N;
-                for (int i = 0; i < 4; i++) {
-                    Pair p = n->prev->adj[Dir(1 << i)];
-                    if (p.node == n && p.d < min) {
-                        min = p.d;
-                        d = Dir(1 << i);
-                    }
-                }
-                optimalPath.push(d);
-                n = n->prev;
+                graphNode &prev = graph[graph[n].prev];
+                std::cout << graph[n].id << "<-" << prev.id << " (" << (graph[n].d - prev.d) << ")" << std::endl;
+                optimalPath.push(Dir(1 << graph[n].prevSlot));      // the slot of prev the search came through
+                n = prev.id;
             }
             printUI("Optimal path calculated (see stdout for more).");
             pathCopy = optimalPath;             // need a copy since we don't want to lose optimalPath
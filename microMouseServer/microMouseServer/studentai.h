@@ -0,0 +1,45 @@
+#ifndef STUDENTAI_H
+#define STUDENTAI_H
+
+#include "mazeSolver.h"
+#include "nodeGraph.h"
+#include "pathSearch.h"
+#include <stack>
+
+// the example AI, write yours in studentai.cpp. Anything it has to remember
+// between two calls of studentAI() goes in here instead of in statics, so every
+// mouse gets its own copy and several sims can run side by side (see mazeBatch)
+class studentSolver : public mazeSolver
+{
+public:
+    // cardinal directions
+    enum Dir { N = 0b0001, E = 0b0010, W = 0b0100, S = 0b1000 };
+
+    studentSolver();
+
+protected:
+    void studentAI();
+
+private:
+    // origin coordinates, the maze's start cell
+    int OX, OY;
+
+    // destination coordinates, the maze's goal cell
+    int DX, DY;
+
+    bool newRun;                // state boolean that resets every time you hit "Start Run"
+    bool firstRun;              // resets every time you change map - indicate map change by enclosing the starting tile in walls and hitting "Start Run"
+    bool graphBuilding;         // if the mouse is currently exploring all nodes to build the node graph
+
+    int x, y;                   // x, y are updated every step
+    Dir lastStep;               // always updated to be the same direction as the step we just took
+
+    nodeGraph graph;            // all nodes, graph.nodeAt(x, y) gives the node on a tile, NONE or DEAD_END
+    std::stack<Dir> s;          // use this stack for backtracking
+    int rootNode;
+    std::stack<Dir> optimalPath;
+    std::stack<Dir> pathCopy;
+    pathSearch search;
+};
+
+#endif // STUDENTAI_H
@@ -0,0 +1,133 @@
+#include "taskPool.h"
+
+taskPool::taskPool(int threads)
+{
+    if(threads <= 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if(threads <= 0)
+    {
+        threads = 1;
+    }
+
+    _pending = 0;
+    _batch = 0;
+    _stop = false;
+    for(int i = 0; i < threads; i++)
+    {
+        _workers.push_back(new worker);
+    }
+    for(int i = 0; i < threads; i++)
+    {
+        _threads.push_back(std::thread(&taskPool::workerLoop, this, i));
+    }
+}
+
+taskPool::~taskPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for(size_t i = 0; i < _threads.size(); i++)
+    {
+        _threads[i].join();
+    }
+    for(size_t i = 0; i < _workers.size(); i++)
+    {
+        delete _workers[i];
+    }
+}
+
+int taskPool::threadCount()
+{
+    return (int)_threads.size();
+}
+
+void taskPool::run(int count, std::function<void(int)> job)
+{
+    if(count <= 0)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(_lock);
+    _job = job;
+    _pending = count;
+
+    //hand out contiguous blocks so neighbouring jobs start on the same core
+    int n = (int)_workers.size();
+    for(int w = 0; w < n; w++)
+    {
+        std::lock_guard<std::mutex> workerGuard(_workers[w]->lock);
+        for(int i = count * w / n; i < count * (w + 1) / n; i++)
+        {
+            _workers[w]->jobs.push_back(i);
+        }
+    }
+    _batch++;
+    _wake.notify_all();
+
+    _done.wait(guard, [this] { return _pending == 0; });
+    _job = NULL;
+}
+
+bool taskPool::takeJob(int id, int &job)
+{
+    worker *own = _workers[id];
+    {
+        std::lock_guard<std::mutex> guard(own->lock);
+        if(!own->jobs.empty())
+        {
+            job = own->jobs.front();
+            own->jobs.pop_front();
+            return true;
+        }
+    }
+
+    //nothing left locally, steal from the back of the other workers
+    int n = (int)_workers.size();
+    for(int i = 1; i < n; i++)
+    {
+        worker *victim = _workers[(id + i) % n];
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if(!victim->jobs.empty())
+        {
+            job = victim->jobs.back();
+            victim->jobs.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void taskPool::workerLoop(int id)
+{
+    long seenBatch = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(_lock);
+            _wake.wait(guard, [&] { return _stop || _batch != seenBatch; });
+            if(_stop)
+            {
+                return;
+            }
+            seenBatch = _batch;
+        }
+
+        int job;
+        while(takeJob(id, job))
+        {
+            _job(job);
+            if(--_pending == 0)
+            {
+                //take the lock so the notify can't slip in before run() starts waiting
+                std::lock_guard<std::mutex> guard(_lock);
+                _done.notify_all();
+            }
+        }
+    }
+}
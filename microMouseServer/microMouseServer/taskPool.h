@@ -0,0 +1,47 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//work stealing thread pool for the headless tools. Each worker owns a deque of
+//job indices and takes from its front, idle workers steal from the back of others
+//so one slow maze doesn't leave the rest of the cores waiting
+class taskPool
+{
+public:
+    explicit taskPool(int threads = 0);
+    ~taskPool();
+
+    int threadCount();
+
+    //calls job(i) for every i in [0,count) and blocks until all of them are done
+    void run(int count, std::function<void(int)> job);
+
+private:
+    struct worker
+    {
+        std::mutex lock;
+        std::deque<int> jobs;
+    };
+
+    void workerLoop(int id);
+    bool takeJob(int id, int &job);
+
+    std::vector<std::thread> _threads;
+    std::vector<worker*> _workers;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    std::function<void(int)> _job;
+    std::atomic<int> _pending;
+    long _batch;
+    bool _stop;
+};
+
+#endif // TASKPOOL_H